@@ -26,6 +26,7 @@
 #include "sim/expressions.hpp"
 #include "sim/proc.hpp"
 #include "sim/sim.hpp"
+#include "util/chrono.hpp"
 #include "util/generic.hpp"
 #include "util/io.hpp"
 #include "util/util.hpp"
@@ -483,6 +484,8 @@ action_t::action_t( action_e ty, util::string_view token, player_t* p, const spe
     starved_proc(),
     queue_failed_proc(),
     total_executions(),
+    apl_profile(),
+    last_ready_failure( ready_failure::NONE ),
     line_cooldown( new cooldown_t( "line_cd", *p ) ),
     signature(),
     execute_state(),
@@ -2453,6 +2456,7 @@ bool action_t::action_ready()
   // Can't find any target to cast on
   if ( !select_target() )
   {
+    last_ready_failure = ready_failure::TARGET;
     return false;
   }
 
@@ -2476,7 +2480,10 @@ bool action_t::action_ready()
     return false;
 
   if ( line_cooldown->down() )
+  {
+    last_ready_failure = ready_failure::COOLDOWN;
     return false;
+  }
 
   if ( sync_action && !sync_action->action_ready() )
     return false;
@@ -2485,21 +2492,68 @@ bool action_t::action_ready()
     return false;
 
   if ( if_expr && !if_expr->success() )
+  {
+    last_ready_failure = ready_failure::EXPRESSION;
     return false;
+  }
 
   return true;
 }
 
+bool action_t::profile_action_ready()
+{
+  // Time every apl_profile_sample_rate'th evaluation of the entry
+  bool sample = apl_profile.evaluations++ % sim->apl_profile_sample_rate == 0;
+  chrono::thread_clock::time_point start;
+  if ( sample )
+  {
+    start = chrono::thread_clock::now();
+  }
+
+  last_ready_failure = ready_failure::NONE;
+  bool is_ready = action_ready();
+
+  if ( sample )
+  {
+    apl_profile.cpu_time += chrono::elapsed_fp_seconds( start );
+    apl_profile.cpu_samples++;
+  }
+
+  if ( is_ready )
+  {
+    apl_profile.successes++;
+  }
+  else
+  {
+    auto reason = last_ready_failure == ready_failure::NONE ? ready_failure::OTHER : last_ready_failure;
+    apl_profile.rejections[ static_cast<unsigned>( reason ) ]++;
+  }
+
+  return is_ready;
+}
+
+void apl_profile_t::merge( const apl_profile_t& other )
+{
+  evaluations += other.evaluations;
+  successes += other.successes;
+  for ( size_t i = 0; i < rejections.size(); ++i )
+  {
+    rejections[ i ] += other.rejections[ i ];
+  }
+  cpu_time += other.cpu_time;
+  cpu_samples += other.cpu_samples;
+}
+
 // Properties that govern if the spell itself is executable, without considering any kind of user
 // options
 bool action_t::ready()
 {
   // Check conditions that do NOT pertain to the target before cycle_targets
-  if ( !cooldown->is_ready() )
-    return false;
-
-  if ( internal_cooldown->down() )
+  if ( !cooldown->is_ready() || internal_cooldown->down() )
+  {
+    last_ready_failure = ready_failure::COOLDOWN;
     return false;
+  }
 
   if ( player->is_moving() && !usable_moving() )
     return false;
@@ -2509,6 +2563,7 @@ bool action_t::ready()
   {
     if ( starved_proc )
       starved_proc->occur();
+    last_ready_failure = ready_failure::RESOURCE;
     return false;
   }
 
@@ -2911,6 +2966,12 @@ void action_t::reset()
 
       player->dynamic_target_action_list.erase( this );
     }
+
+    // Memoize once the expression tree is final
+    if ( sim->memoize_expressions && sim->current_iteration >= sim->optimize_expressions - 1 )
+    {
+      expression::memoize( if_expr, *this );
+    }
   }
   expr_t::optimize_expression( target_if_expr, *sim );
   expr_t::optimize_expression( interrupt_if_expr, *sim );
@@ -5135,28 +5196,26 @@ player_t* action_t::select_target_if_target()
     return target;
   }
 
-  std::vector<player_t*> master_list;
+  auto& scratch = target_if_scratch;
   if ( sim->distance_targeting_enabled )
   {
     if ( !target_cache.is_valid )
     {
       available_targets( target_cache.list );
-      master_list = targets_in_range_list( target_cache.list );
+      targets_in_range_list( target_cache.list );
       target_cache.is_valid = true;
     }
-    else
-    {
-      master_list = target_cache.list;
-    }
 
-    sim->print_debug( "{} Number of targets found in range: {}", *player, master_list.size() );
+    scratch.targets = target_cache.list;
+
+    sim->print_debug( "{} Number of targets found in range: {}", *player, scratch.targets.size() );
 
-    if ( master_list.size() <= 1 )
+    if ( scratch.targets.size() <= 1 )
       return target;
   }
   else
   {
-    master_list = target_list();
+    scratch.targets = target_list();
   }
 
   player_t* original_target = target;
@@ -5166,41 +5225,87 @@ player_t* action_t::select_target_if_target()
   double max_ = current_target_v;
   double min_ = current_target_v;
 
-  for ( auto p : master_list )
+  if ( target_if_mode == TARGET_IF_FIRST )
   {
-    target = p;
+    for ( auto p : scratch.targets )
+    {
+      target = p;
 
-    // No need to check current target
-    if ( target == original_target )
-      continue;
+      // No need to check current target
+      if ( target == original_target )
+        continue;
 
-    if ( !target_ready( target ) )
-    {
-      continue;
+      if ( !target_ready( target ) )
+      {
+        continue;
+      }
+
+      double v = target_if_expr->evaluate();
+
+      // Don't swap to targets that evaluate to identical value than the current
+      // target
+      if ( v != current_target_v && v != 0 )
+      {
+        current_target_v = v;
+        proposed_target = target;
+        break;
+      }
     }
+  }
+  else
+  {
+    // Min/max needs the value of every candidate, so collect them first and score them in one
+    // batch where the expression supports it
+    scratch.candidates.clear();
+    scratch.expression_targets.clear();
+    for ( auto p : scratch.targets )
+    {
+      target = p;
 
-    double v = target_if_expr->evaluate();
+      // No need to check current target
+      if ( target == original_target )
+        continue;
 
-    // Don't swap to targets that evaluate to identical value than the current
-    // target
-    if ( v == current_target_v )
-      continue;
+      if ( !target_ready( target ) )
+      {
+        continue;
+      }
 
-    if ( target_if_mode == TARGET_IF_FIRST && v != 0 )
-    {
-      current_target_v = v;
-      proposed_target = target;
-      break;
+      scratch.candidates.push_back( target );
+      scratch.expression_targets.push_back( get_expression_target() );
     }
-    else if ( target_if_mode == TARGET_IF_MAX && v > max_ )
+
+    target = original_target;
+    scratch.values.resize( scratch.candidates.size() );
+
+    if ( !target_if_expr->evaluate_targets( *this, scratch.expression_targets, scratch.values ) )
     {
-      max_ = v;
-      proposed_target = target;
+      for ( size_t i = 0; i < scratch.candidates.size(); ++i )
+      {
+        target = scratch.candidates[ i ];
+        scratch.values[ i ] = target_if_expr->evaluate();
+      }
     }
-    else if ( target_if_mode == TARGET_IF_MIN && v < min_ )
+
+    for ( size_t i = 0; i < scratch.candidates.size(); ++i )
     {
-      min_ = v;
-      proposed_target = target;
+      double v = scratch.values[ i ];
+
+      // Don't swap to targets that evaluate to identical value than the current
+      // target
+      if ( v == current_target_v )
+        continue;
+
+      if ( target_if_mode == TARGET_IF_MAX && v > max_ )
+      {
+        max_ = v;
+        proposed_target = scratch.candidates[ i ];
+      }
+      else if ( target_if_mode == TARGET_IF_MIN && v < min_ )
+      {
+        min_ = v;
+        proposed_target = scratch.candidates[ i ];
+      }
     }
   }
 
@@ -132,6 +132,40 @@ struct parsed_value_t
   { return value().total_millis(); }
 };
 
+// Per APL entry evaluation statistics, collected when the apl_profile option is enabled
+struct apl_profile_t
+{
+  uint64_t evaluations = 0;
+  uint64_t successes = 0;
+  std::array<uint64_t, static_cast<unsigned>( ready_failure::MAX )> rejections {};
+  // Thread CPU time spent in the sampled evaluations, in seconds
+  double cpu_time = 0;
+  uint64_t cpu_samples = 0;
+
+  void merge( const apl_profile_t& other );
+
+  double pass_rate() const
+  { return evaluations ? successes / static_cast<double>( evaluations ) : 0; }
+
+  // Entry rejected without evaluating action_ready()
+  void reject( ready_failure f )
+  {
+    evaluations++;
+    rejections[ static_cast<unsigned>( f ) ]++;
+  }
+
+  double rejection_rate( ready_failure f ) const
+  { return evaluations ? rejections[ static_cast<unsigned>( f ) ] / static_cast<double>( evaluations ) : 0; }
+
+  // Mean CPU time of an evaluation, in seconds
+  double cpu_time_per_evaluation() const
+  { return cpu_samples ? cpu_time / cpu_samples : 0; }
+
+  // Estimated CPU time of all evaluations, in seconds
+  double total_cpu_time() const
+  { return cpu_time_per_evaluation() * evaluations; }
+};
+
 struct action_t : private noncopyable
 {
 public:
@@ -643,6 +677,10 @@ public:
   proc_t* queue_failed_proc;
   uint_least64_t total_executions;
 
+  /// APL profiling data of the action list entry, and the reason of the latest failed readiness check
+  apl_profile_t apl_profile;
+  ready_failure last_ready_failure;
+
   /**
    * @brief Cooldown for specific APL line.
    *
@@ -678,6 +716,14 @@ public:
     target_cache_t() : is_valid( false ) {}
   } mutable target_cache;
 
+  /// Reusable buffers for target_if evaluation, so target selection does not allocate
+  struct target_if_scratch_t {
+    std::vector<player_t*> targets;
+    std::vector<player_t*> candidates;
+    std::vector<player_t*> expression_targets;
+    std::vector<double> values;
+  } target_if_scratch;
+
 private:
   std::vector<std::unique_ptr<option_t>> options;
   action_state_t* state_cache;
@@ -1110,6 +1156,8 @@ public:
   /// Is the action ready, as a combination of ability characteristics and user input? Main
   /// ntry-point when selecting something to do for an actor.
   virtual bool action_ready();
+  /// action_ready(), recording the APL profiling data of the entry
+  bool profile_action_ready();
   /// Select a target to execute on
   virtual bool select_target();
   /// Target readiness state checking
@@ -123,6 +123,7 @@ void dot_t::adjust_duration( timespan_t extra_seconds, timespan_t max_total_time
 
   current_duration += extra_seconds;
   extra_time += extra_seconds;
+  sim.bump_state_generation( state_generation::DOT );
 
   timespan_t new_remains = remains + extra_seconds;
   if ( new_remains > remains )
@@ -176,6 +177,8 @@ void dot_t::reset()
   current_duration = timespan_t::min();
   if ( state )
     action_state_t::release( state );
+
+  sim.bump_state_generation( state_generation::DOT );
 }
 
 /* Trigger a dot with given duration.
@@ -328,6 +331,7 @@ void dot_t::copy( player_t* destination, dot_copy_e copy_type, action_t* copy_ac
 
     other_dot->ticking   = true;
     other_dot->end_event = make_event<dot_end_event_t>( sim, other_dot, new_duration );
+    sim.bump_state_generation( state_generation::DOT );
 
     // The clone may happen on tick, or mid tick. If it happens on tick, the
     // source dot will not have a new tick event scheduled yet, so the tick
@@ -355,6 +359,7 @@ struct dot_expr_t : public expr_t
   action_t* action, * source_action;
   bool dynamic;
   target_specific_t<dot_t> specific_dot;
+  unsigned dependency_mask;
 
   dot_expr_t( util::string_view n, dot_t* d, action_t* a, action_t* sa, bool dy )
     : expr_t( n ),
@@ -362,7 +367,8 @@ struct dot_expr_t : public expr_t
       action( a ),
       source_action( sa ),
       dynamic( dy ),
-      specific_dot( false )
+      specific_dot( false ),
+      dependency_mask( expression::UNKNOWN_DEPENDENCIES )
   {
   }
 
@@ -375,8 +381,11 @@ struct dot_expr_t : public expr_t
     if ( !dynamic )
       return static_dot;
 
-    player_t* dot_target = source_action->get_expression_target();
+    return target_dot( source_action->get_expression_target() );
+  }
 
+  dot_t* target_dot( player_t* dot_target )
+  {
     action->player->get_target_data( dot_target );
 
     dot_t*& dot = specific_dot[ dot_target ];
@@ -385,6 +394,33 @@ struct dot_expr_t : public expr_t
 
     return dot;
   }
+
+  virtual double value( dot_t* dot ) = 0;
+
+  unsigned dependencies() const override
+  {
+    return dependency_mask;
+  }
+
+  double evaluate() override
+  {
+    return value( dot() );
+  }
+
+  // Score all target_if candidates in one pass over their target data
+  bool evaluate_targets( const action_t& a, util::span<player_t* const> expression_targets,
+                         util::span<double> results ) override
+  {
+    if ( !dynamic || source_action != &a )
+      return false;
+
+    for ( size_t i = 0; i < expression_targets.size(); ++i )
+    {
+      results[ i ] = value( target_dot( expression_targets[ i ] ) );
+    }
+
+    return true;
+  }
 };
 
 template <typename Fn>
@@ -397,9 +433,9 @@ struct fn_dot_expr_t final : public dot_expr_t
     : dot_expr_t( n, d, a, sa, dy ), fn( std::forward<T>( fn ) )
   { }
 
-  double evaluate() override
+  double value( dot_t* dot ) override
   {
-    return coerce( fn( dot() ) );
+    return coerce( fn( dot ) );
   }
 };
 
@@ -422,6 +458,11 @@ std::unique_ptr<expr_t> dot_t::create_expression( dot_t* dot, action_t* action,
     return std::make_unique<fn_dot_expr_t<std::decay_t<Fn>>>(
             n, dot, action, source_action, dynamic, std::forward<Fn>( fn ) );
   };
+  // Expressions that only read dot state changed through dot_t methods
+  auto tracked = []( auto expr ) {
+    expr->dependency_mask = expression::depends_on( state_generation::DOT );
+    return expr;
+  };
 
   if ( name_str == "ticks" )
   {
@@ -471,10 +512,10 @@ std::unique_ptr<expr_t> dot_t::create_expression( dot_t* dot, action_t* action,
   }
   else if ( name_str == "remains" )
   {
-    return make_dot_expr( "dot_remains",
+    return tracked( make_dot_expr( "dot_remains",
       []( dot_t* dot ) {
         return dot->remains();
-      } );
+      } ) );
   }
   else if ( name_str == "tick_dmg" )
   {
@@ -531,10 +572,10 @@ std::unique_ptr<expr_t> dot_t::create_expression( dot_t* dot, action_t* action,
   }
   else if ( name_str == "ticking" )
   {
-    return make_dot_expr( "dot_ticking",
+    return tracked( make_dot_expr( "dot_ticking",
       []( dot_t* dot ) {
         return dot->is_ticking();
-      } );
+      } ) );
   }
   else if ( name_str == "spell_power" )
   {
@@ -853,6 +894,7 @@ void dot_t::start( timespan_t duration )
 
   ticking = true;
   stack   = 1;
+  sim.bump_state_generation( state_generation::DOT );
 
   end_event = make_event<dot_end_event_t>( sim, this, current_duration );
 
@@ -874,6 +916,7 @@ void dot_t::refresh( timespan_t duration )
 {
   current_duration =
       current_action->calculate_dot_refresh_duration( this, duration );
+  sim.bump_state_generation( state_generation::DOT );
 
   if ( stack < max_stack )
     stack++;
@@ -981,6 +1024,7 @@ void dot_t::adjust( double coefficient )
 
   event_t::cancel( tick_event );
   event_t::cancel( end_event );
+  sim.bump_state_generation( state_generation::DOT );
 
   current_duration = new_duration;
   tick_time        = tick_time * coefficient;
@@ -1021,6 +1065,7 @@ void dot_t::adjust_full_ticks( double coefficient )
     new_tick_remains += new_tick_time;
   }
   event_t::cancel( end_event );
+  sim.bump_state_generation( state_generation::DOT );
 
   sim.print_log( "{} exsanguinates dot {} (on {}): duration={:.3f} -> {:.3f}, next_tick={:.3f} -> {:.3f}, ends={:.3f} -> {:.3f}",
                  *current_action->player, *current_action, *target,
@@ -1092,6 +1137,7 @@ dot_t::dot_end_event_t::dot_end_event_t(dot_t* d, timespan_t time_to_end) :
 void dot_t::dot_end_event_t::execute()
 {
   dot->end_event = nullptr;
+  sim().bump_state_generation( state_generation::DOT );
 
   assert( dot->tick_event );
   if ( dot->time_to_next_full_tick() < dot->tick_time )
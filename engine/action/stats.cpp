@@ -49,6 +49,11 @@ stats_t::stats_t( util::string_view n, player_t* p ) :
   scaling( nullptr ),
   timeline_amount( nullptr )
 {
+  actual_amount.change_sketch( sim.statistics_sketch );
+  total_amount.change_sketch( sim.statistics_sketch );
+  portion_aps.change_sketch( sim.statistics_sketch );
+  portion_apse.change_sketch( sim.statistics_sketch );
+
   int size = std::min( sim.iterations, 10000 );
   actual_amount.reserve( size );
   total_amount.reserve( size );
@@ -58,6 +63,8 @@ stats_t::stats_t( util::string_view n, player_t* p ) :
   if ( sim.report_details != 0 )
   {
     timeline_amount = std::make_unique<sc_timeline_t>( );
+    timeline_amount -> set_bin_size( sim.timeline_bin_size );
+    timeline_amount -> reserve( timespan_t::from_seconds( sim.expected_max_time() ) );
   }
 }
 
@@ -153,9 +160,20 @@ void stats_t::add_result( double act_amount,
   r -> iteration_count += 1;
   r -> iteration_actual_amount += act_amount;
   r -> iteration_total_amount += tot_amount;
+
+  if ( sim.data_collection < data_collection_level::SUMMARY )
+  {
+    return;
+  }
+
   r -> actual_amount.add( act_amount );
   r -> total_amount.add( tot_amount );
 
+  if ( sim.data_collection < data_collection_level::FULL )
+  {
+    return;
+  }
+
   // Collect timeline data to stats-specific object if it exists, or to the player's global "damage
   // output" timeline (e.g., when report_details=0).
   if ( timeline_amount )
@@ -189,8 +207,9 @@ void stats_t::add_execute( timespan_t time,
   iteration_num_executes++;
   iteration_total_execute_time += time;
 
-  if ( last_execute > timespan_t::zero() &&
-               last_execute != sim.current_time() )
+  if ( sim.data_collection >= data_collection_level::SUMMARY &&
+       last_execute > timespan_t::zero() &&
+       last_execute != sim.current_time() )
   {
     total_intervals.add( sim.current_time().total_seconds() - last_execute.total_seconds() );
   }
@@ -236,28 +255,27 @@ void stats_t::datacollection_end()
   double idr = 0;
   double itr = 0;
 
-  range::for_each( direct_results, [ &idr, &iaa, &ita ]( stats_results_t& r ) {
+  bool summary = sim.data_collection >= data_collection_level::SUMMARY;
+
+  range::for_each( direct_results, [ &idr, &iaa, &ita, summary ]( stats_results_t& r ) {
     idr += r.iteration_count;
     iaa += r.iteration_actual_amount;
     ita += r.iteration_total_amount;
 
-    r.datacollection_end();
+    if ( summary )
+      r.datacollection_end();
   } );
 
-  range::for_each( tick_results, [ &itr, &iaa, &ita ]( stats_results_t& r ) {
+  range::for_each( tick_results, [ &itr, &iaa, &ita, summary ]( stats_results_t& r ) {
     itr += r.iteration_count;
     iaa += r.iteration_actual_amount;
     ita += r.iteration_total_amount;
 
-    r.datacollection_end();
+    if ( summary )
+      r.datacollection_end();
   } );
 
-  actual_amount.add( iaa );
-  total_amount.add( ita );
-
-  total_execute_time.add( iteration_total_execute_time.total_seconds() );
-  total_tick_time.add( iteration_total_tick_time.total_seconds() );
-
+  // The actor's iteration amounts feed its metrics, and are always collected
   if ( type == STATS_DMG )
     player -> iteration_dmg += iaa;
   else if ( type == STATS_HEAL )
@@ -265,6 +283,17 @@ void stats_t::datacollection_end()
   else if ( type == STATS_ABSORB )
     player -> iteration_absorb += iaa;
 
+  if ( !summary )
+  {
+    return;
+  }
+
+  actual_amount.add( iaa );
+  total_amount.add( ita );
+
+  total_execute_time.add( iteration_total_execute_time.total_seconds() );
+  total_tick_time.add( iteration_total_tick_time.total_seconds() );
+
   auto uptime = player -> composite_active_time();
 
   portion_aps.add( uptime != timespan_t::zero() ? iaa / uptime.total_seconds() : 0 );
@@ -276,6 +305,11 @@ void stats_t::datacollection_end()
   num_direct_results.add( idr );
   num_tick_results.add( itr );
 
+  if ( sim.data_collection < data_collection_level::FULL )
+  {
+    return;
+  }
+
   if ( timeline_amount )
   {
     timeline_amount -> add( sim.current_time(), 0.0 );
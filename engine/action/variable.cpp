@@ -203,6 +203,14 @@ void variable_t::reset()
   if ( !var )
     return;
 
+  // Variable expressions are final once the variable optimization passes are done
+  if ( sim->memoize_expressions && sim->current_iteration >= sim->optimize_expressions - 1 )
+  {
+    expression::memoize( value_expression, *this );
+    expression::memoize( condition_expression, *this );
+    expression::memoize( value_else_expression, *this );
+  }
+
   // In addition to if= expression removing the variable from the APLs, if the the variable value
   // is constant, we can remove any variable action referencing it from the APL
   if (action_list && sim->optimize_expressions && player->nth_iteration() == 1 &&
@@ -299,6 +307,8 @@ void variable_t::execute()
       static_cast<int>(operation), var->current_value_, var->default_value_, signature_str);
   }
 
+  double old_value = var->current_value_;
+
   switch (operation)
   {
   case OPERATION_SET:
@@ -378,6 +388,11 @@ void variable_t::execute()
     assert(0);
     break;
   }
+
+  if ( var->current_value_ != old_value )
+  {
+    sim->bump_state_generation( state_generation::VARIABLE );
+  }
 }
 
 void cycling_variable_t::execute()
@@ -34,10 +34,11 @@ struct buff_expr_t : public expr_t
   action_t* action;
   buff_t* static_buff;
   target_specific_t<buff_t> specific_buff;
+  unsigned dependency_mask;
 
   buff_expr_t( util::string_view n, util::string_view bn, action_t* a, buff_t* b )
     : expr_t( get_full_expression_name( n, bn ) ), buff_name( bn ), action( a ),
-    static_buff( b ), specific_buff( false )
+    static_buff( b ), specific_buff( false ), dependency_mask( expression::UNKNOWN_DEPENDENCIES )
   {
   }
 
@@ -95,6 +96,46 @@ struct buff_expr_t : public expr_t
   {
     return buff()->s_data != spell_data_t::nil() && !buff()->s_data->ok();
   }
+
+  virtual double value( buff_t* buff ) = 0;
+
+  double evaluate() override
+  {
+    return value( buff() );
+  }
+
+  unsigned dependencies() const override
+  {
+    return dependency_mask;
+  }
+
+  // Score all target_if candidates at once. Buffs not created yet for a target need the action
+  // target to be switched, in which case the caller falls back to evaluate().
+  bool evaluate_targets( const action_t& a, util::span<player_t* const> expression_targets,
+                         util::span<double> results ) override
+  {
+    if ( static_buff )
+    {
+      range::fill( results, value( static_buff ) );
+      return true;
+    }
+
+    if ( action != &a )
+      return false;
+
+    for ( auto t : expression_targets )
+    {
+      if ( !specific_buff[ t ] )
+        return false;
+    }
+
+    for ( size_t i = 0; i < expression_targets.size(); ++i )
+    {
+      results[ i ] = value( specific_buff[ expression_targets[ i ] ] );
+    }
+
+    return true;
+  }
 };
 
 template <typename Fn>
@@ -107,9 +148,9 @@ struct fn_buff_expr_t final : public buff_expr_t
     : buff_expr_t( n, bn, a, b ), fn( std::forward<T>( fn ) )
   { }
 
-  double evaluate() override
+  double value( buff_t* buff ) override
   {
-    return coerce( fn( buff() ) );
+    return coerce( fn( buff ) );
   }
 };
 
@@ -118,21 +159,34 @@ struct fn_const_buff_expr_t final : public buff_expr_t
 {
   Fn fn;
   K is_const_fn;
+  // Direct read of the stack count of a static buff, if fn is a stack based query
+  expression::load_t::kind_e load_kind;
 
   template <typename T = Fn, typename U = K>
   fn_const_buff_expr_t( util::string_view n, util::string_view bn, action_t* a, buff_t* b, T&& fn, U&& is_const_fn )
-    : buff_expr_t( n, bn, a, b ), fn( std::forward<T>( fn ) ), is_const_fn( std::forward<U>( is_const_fn ) )
+    : buff_expr_t( n, bn, a, b ), fn( std::forward<T>( fn ) ), is_const_fn( std::forward<U>( is_const_fn ) ),
+      load_kind( expression::load_t::NONE )
   { }
 
-  double evaluate() override
+  double value( buff_t* buff ) override
   {
-    return coerce( fn( buff() ) );
+    return coerce( fn( buff ) );
   }
-  
+
   bool is_constant() override
   {
     return is_const_fn( buff() );
   }
+
+  bool load( expression::load_t& l ) const override
+  {
+    if ( !static_buff || load_kind == expression::load_t::NONE )
+      return false;
+
+    l.kind    = load_kind;
+    l.address = &static_buff->current_stack;
+    return true;
+  }
 };
 
 struct buff_event_t : public event_t
@@ -346,11 +400,19 @@ std::unique_ptr<expr_t> create_buff_expression( util::string_view buff_name, uti
     return std::make_unique<fn_buff_expr_t<std::decay_t<Fn>>>(
             n, buff_name, action, static_buff, std::forward<Fn>( fn ) );
   };  
-  auto make_const_buff_expr = [buff_name, action, static_buff]( util::string_view n, auto&& fn, auto&& is_const_fn ) {
+  auto make_const_buff_expr = [buff_name, action, static_buff]( util::string_view n, auto&& fn, auto&& is_const_fn,
+                                                                 expression::load_t::kind_e load_kind = expression::load_t::NONE ) {
     using Fn = decltype(fn);
     using Fn_const = decltype(is_const_fn);
-    return std::make_unique<fn_const_buff_expr_t<std::decay_t<Fn>, std::decay_t<Fn_const>>>(
+    auto expr = std::make_unique<fn_const_buff_expr_t<std::decay_t<Fn>, std::decay_t<Fn_const>>>(
             n, buff_name, action, static_buff, std::forward<Fn>( fn ), std::forward<Fn_const>( is_const_fn ) );
+    expr->load_kind = load_kind;
+    return expr;
+  };
+  // Expressions that only read buff state changed through buff_t methods
+  auto tracked = []( auto expr ) {
+    expr->dependency_mask = expression::depends_on( state_generation::BUFF );
+    return expr;
   };
 
   if ( type == "duration" )
@@ -369,13 +431,13 @@ std::unique_ptr<expr_t> create_buff_expression( util::string_view buff_name, uti
   }
   else if ( type == "remains" )
   {
-    return make_const_buff_expr( "buff_remains",
+    return tracked( make_const_buff_expr( "buff_remains",
       []( buff_t* buff ) {
         return buff->remains();
       },
       []( buff_t* buff ) {
         return buff->default_chance == 0;
-      } );
+      } ) );
   }
   else if ( type == "tick_time" )
   {
@@ -403,34 +465,37 @@ std::unique_ptr<expr_t> create_buff_expression( util::string_view buff_name, uti
   }
   else if ( type == "up" )
   {
-    return make_const_buff_expr( "buff_up",
+    return tracked( make_const_buff_expr( "buff_up",
       []( buff_t* buff ) {
         return buff->check() > 0;
       },
       []( buff_t* buff ) {
         assert( buff->check() == 0 || buff->default_chance != 0);
         return buff->default_chance == 0;
-      } );
+      },
+      expression::load_t::STACK_UP ) );
   }
   else if ( type == "down" )
   {
-    return make_const_buff_expr( "buff_down",
+    return tracked( make_const_buff_expr( "buff_down",
       []( buff_t* buff ) {
         return buff->check() <= 0;
       },
       []( buff_t* buff ) {
         return buff->default_chance == 0;
-      } );
+      },
+      expression::load_t::STACK_DOWN ) );
   }
   else if ( type == "stack" )
   {
-    return make_const_buff_expr( "buff_stack",
+    return tracked( make_const_buff_expr( "buff_stack",
       []( buff_t* buff ) {
         return buff->check();
       },
       []( buff_t* buff ) {
         return buff->default_chance == 0;
-      } );
+      },
+      expression::load_t::INT ) );
   }
   else if ( type == "stack_pct" )
   {
@@ -483,8 +548,8 @@ std::unique_ptr<expr_t> create_buff_expression( util::string_view buff_name, uti
         return b;
       }
 
-      double evaluate() override
-      { return buff()->stack_react(); }
+      double value( buff_t* buff ) override
+      { return buff->stack_react(); }
       
       bool is_constant() override
       {
@@ -512,8 +577,8 @@ std::unique_ptr<expr_t> create_buff_expression( util::string_view buff_name, uti
         return b;
       }
 
-      double evaluate() override
-      { return 100.0 * buff()->stack_react() / buff()->max_stack(); }
+      double value( buff_t* buff ) override
+      { return 100.0 * buff->stack_react() / buff->max_stack(); }
       
       bool is_constant() override
       {
@@ -534,6 +599,7 @@ std::unique_ptr<expr_t> create_buff_expression( util::string_view buff_name, uti
   }
   else if ( type == "last_trigger" )
   {
+    // Triggers of overridden buffs update last_trigger without changing the buff
     return make_const_buff_expr( "buff_last_trigger",
       []( buff_t* buff ) {
         return buff->last_trigger_time();
@@ -544,13 +610,13 @@ std::unique_ptr<expr_t> create_buff_expression( util::string_view buff_name, uti
   }
   else if ( type == "last_expire" )
   {
-    return make_const_buff_expr( "buff_last_expire",
+    return tracked( make_const_buff_expr( "buff_last_expire",
       []( buff_t* buff ) {
         return buff->last_expire_time();
       },
       []( buff_t* buff ) {
         return buff->default_chance == 0;
-      } );
+      } ) );
   }
   else if ( type == "expiration_delay_remains" )
   {
@@ -849,6 +915,7 @@ buff_t* buff_t::set_dynamic_time_duration_multiplier( double new_multiplier )
   }
 
   auto ratio = new_multiplier / old_multiplier;
+  sim->bump_state_generation( state_generation::BUFF );
 
   // Slowing down the clock, expiry will be moved into the future
   if ( ratio > 1.0 )
@@ -2130,6 +2197,7 @@ void buff_t::decrement( int stacks, double value )
       stack_uptime[ current_stack ].update( false, sim->current_time() );
 
     current_stack -= stacks;
+    sim->bump_state_generation( state_generation::BUFF );
 
     if ( value != DEFAULT_VALUE() )
       current_value = value;
@@ -2176,6 +2244,7 @@ void buff_t::extend_duration( player_t* p, timespan_t extra_seconds )
   assert( expiration.size() == 1 );
 
   extra_seconds = extra_seconds * get_time_duration_multiplier();
+  sim->bump_state_generation( state_generation::BUFF );
 
   if ( extra_seconds > timespan_t::zero() )
   {
@@ -2320,6 +2389,8 @@ void buff_t::start( int stacks, double value, timespan_t duration )
     last_start = sim->current_time();
   }
 
+  sim->bump_state_generation( state_generation::BUFF );
+
   if ( d > timespan_t::zero() )
   {
     expiration.push_back( make_event<expiration_t>( *sim, this, stacks, d ) );
@@ -2389,6 +2460,8 @@ void buff_t::refresh( int stacks, double value, timespan_t duration )
   if ( refresh_behavior == buff_refresh_behavior::DISABLED && duration != timespan_t::zero() )
     return;
 
+  sim->bump_state_generation( state_generation::BUFF );
+
   // Make sure we always cancel the expiration event if we get an
   // infinite duration
   if ( d <= timespan_t::zero() )
@@ -2470,6 +2543,7 @@ void buff_t::bump( int stacks, double value )
     changes_stack_value = true;
   }
   current_value = value;
+  sim->bump_state_generation( state_generation::BUFF );
 
   int old_stack = current_stack;
 
@@ -2678,6 +2752,7 @@ void buff_t::expire( timespan_t d )
     event_t::cancel( expiration_delay );
   }
   last_expire = sim->current_time();
+  sim->bump_state_generation( state_generation::BUFF );
 
   timespan_t remaining_duration = timespan_t::zero();
   int expiration_stacks         = current_stack;
@@ -2834,6 +2909,7 @@ void buff_t::reset()
   last_expire       = timespan_t::min();
   last_stack_change = timespan_t::min();
   dynamic_time_duration_multiplier = 1.0;
+  sim->bump_state_generation( state_generation::BUFF );
 }
 
 void buff_t::merge( const buff_t& other )
@@ -3408,6 +3484,7 @@ void stat_buff_t::decrement( int stacks, double /* value */ )
       buff_stat.current_value -= delta;
     }
     current_stack -= stacks;
+    sim->bump_state_generation( state_generation::BUFF );
 
     invalidate_cache();
 
@@ -3514,6 +3591,7 @@ void cost_reduction_buff_t::decrement( int stacks, double /* value */ )
     player->cost_reduction_loss( school, delta );
     current_stack -= stacks;
     current_value -= delta;
+    sim->bump_state_generation( state_generation::BUFF );
   }
 }
 
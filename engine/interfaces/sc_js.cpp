@@ -298,6 +298,7 @@ namespace js {
     v_.AddMember(rapidjson::StringRef("mean_std_dev"), v.mean_stddev(), d_.GetAllocator());
     v_.AddMember(rapidjson::StringRef("min"), v.min(), d_.GetAllocator());
     v_.AddMember(rapidjson::StringRef("max"), v.max(), d_.GetAllocator());
+    v_.AddMember(rapidjson::StringRef("bin_size"), v.bin_size(), d_.GetAllocator());
 
     rapidjson::Value data_arr(rapidjson::kArrayType);
     range::for_each(v.data(), [&data_arr, this](double dp) {
@@ -8,6 +8,7 @@
 #include "config.hpp"
 
 #include "util/string_view.hpp"
+#include "util/timespan.hpp"
 
 #include <string>
 #include <cstdint>
@@ -48,6 +49,11 @@ struct action_priority_list_t
   std::vector<action_t*> foreground_action_list;
   std::vector<action_t*> off_gcd_actions;
   std::vector<action_t*> cast_while_casting_actions;
+  // Readiness index (sim option apl_readiness_index), earliest time the cooldowns of each entry of
+  // the action vectors above allow it to be ready
+  std::vector<timespan_t> foreground_ready_at;
+  std::vector<timespan_t> off_gcd_ready_at;
+  std::vector<timespan_t> cast_while_casting_ready_at;
   int random; // Used to determine how faceroll something actually is. :D
   action_priority_list_t(util::string_view name, player_t* p, util::string_view list_comment = {}) :
     internal_id(0), internal_id_mask(0), name_str(name), action_list_comment_str(list_comment), player(p), used(false),
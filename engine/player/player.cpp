@@ -1105,6 +1105,8 @@ player_t::player_t( sim_t* s, player_e t, util::string_view n, race_e r )
     // Actions
     use_default_action_list( false ),
     precombat_action_list( 0 ),
+    precombat_decisions( PRECOMBAT_EVALUATE ),
+    precombat_decision_list(),
     active_action_list(),
     default_action_list(),
     active_off_gcd_list(),
@@ -2231,6 +2233,8 @@ void player_t::init_resources( bool force )
     }
   }
 
+  sim->bump_state_generation( state_generation::RESOURCE );
+
   // Only collect pet resource timelines if they get reported separately
   if ( !is_pet() || sim->report_pets_separately )
   {
@@ -2240,7 +2244,12 @@ void player_t::init_resources( bool force )
       {
         if ( resources.max[ resource ] > 0 )
         {
-          collected_data.resource_timelines.emplace_back( resource );
+          auto& tl = collected_data.resource_timelines.emplace_back( resource ).timeline;
+          tl.set_bin_size( sim->timeline_bin_size );
+          if ( sim->data_collection == data_collection_level::FULL )
+          {
+            tl.reserve( timespan_t::from_seconds( sim->expected_max_time() ) );
+          }
         }
       }
     }
@@ -3725,6 +3734,11 @@ void player_t::init_finished()
     }
   }
 
+  if ( sim->precombat_decision_cache )
+  {
+    precombat_decisions = PRECOMBAT_RECORD;
+  }
+
   for ( auto action : action_list )
   {
     try
@@ -3737,6 +3751,11 @@ void player_t::init_finished()
     }
   }
 
+  if ( sim->apl_readiness_index )
+  {
+    init_readiness_index();
+  }
+
   // Naive recording of minimum energy thresholds for the actor.
   // TODO: Energy pooling, and energy-based expressions (energy>=10) are not included yet
   for ( auto action : action_list )
@@ -5599,52 +5618,110 @@ void player_t::precombat_init()
   init_resources( true );
 }
 
-void player_t::combat_begin()
+/**
+ * Execute the precombat action list.
+ *
+ * With sim->precombat_decision_cache, the precombat action decisions ( which actions execute, on
+ * which targets ) of the first iteration are cached, and later iterations execute the cached actions
+ * without evaluating readiness or conditions. Only the decisions are cached, the actions still
+ * execute and change the actor state every iteration. Caching is abandoned ( and the list is
+ * evaluated every iteration ) if a decision could depend on the iteration: random numbers were drawn
+ * before or while evaluating it, or its condition is not constant, for example because it refers to
+ * the fight length.
+ */
+void player_t::execute_precombat_actions()
 {
-  if ( !precombat_initialized )
-    precombat_init();
-
-  // Trigger registered pre-pull functions
-  for ( const auto& f : precombat_begin_functions )
+  if ( precombat_decisions == PRECOMBAT_CACHED )
   {
-    f( this );
+    for ( const auto& [ action, target ] : precombat_decision_list )
+    {
+      action->set_target( target );
+      if ( !is_enemy() )
+      {
+        sequence_add( action, target, sim->current_time() );
+      }
+      action->execute();
+    }
+    return;
   }
 
-  // Execute pre-combat actions
-  if ( !is_pet() && !is_add() )
+  bool record = precombat_decisions == PRECOMBAT_RECORD;
+  uint64_t rng_position = record ? rng().position() : 0;
+  auto execute = [ this, &record ]( action_t* action ) {
+    if ( !is_enemy() )
+    {
+      sequence_add( action, action->target, sim->current_time() );
+    }
+    if ( record )
+    {
+      precombat_decision_list.emplace_back( action, action->target );
+    }
+    action->execute();
+  };
+
+  for ( auto& action : precombat_action_list )
   {
-    for ( auto& action : precombat_action_list )
+    if ( record && ( rng().position() != rng_position || action->target_if_expr ||
+                     ( action->if_expr && !action->if_expr->is_constant() ) ) )
+    {
+      record = false;
+    }
+
+    bool ready = action->action_ready();
+    if ( record && rng().position() != rng_position )
     {
-      if ( action->action_ready() )
+      record = false;
+    }
+
+    if ( ready )
+    {
+      if ( action->harmful )
       {
-        if ( action->harmful )
+        if ( first_cast )
         {
-          if ( first_cast )
-          {
-            if ( !is_enemy() )
-            {
-              sequence_add( action, action->target, sim->current_time() );
-            }
-            action->execute();
-            first_cast = false;
-          }
-          else
-          {
-            sim->print_debug( "{} attempting to cast multiple harmful spells during pre-combat.", *this );
-          }
+          execute( action );
+          first_cast = false;
         }
         else
         {
-          if ( !is_enemy() )
-          {
-            sequence_add( action, action->target, sim->current_time() );
-          }
-          action->execute();
+          sim->print_debug( "{} attempting to cast multiple harmful spells during pre-combat.", *this );
         }
       }
-      if ( in_combat && ( action->channeled || action->travel_time() == timespan_t::zero() ) )
-        break;
+      else
+      {
+        execute( action );
+      }
+    }
+    if ( in_combat && ( action->channeled || action->travel_time() == timespan_t::zero() ) )
+      break;
+  }
+
+  if ( precombat_decisions == PRECOMBAT_RECORD )
+  {
+    precombat_decisions = record ? PRECOMBAT_CACHED : PRECOMBAT_EVALUATE;
+    if ( !record )
+    {
+      precombat_decision_list.clear();
     }
+    sim->print_debug( "{} precombat action decisions {} cached.", *this, record ? "are" : "can not be" );
+  }
+}
+
+void player_t::combat_begin()
+{
+  if ( !precombat_initialized )
+    precombat_init();
+
+  // Trigger registered pre-pull functions
+  for ( const auto& f : precombat_begin_functions )
+  {
+    f( this );
+  }
+
+  // Execute pre-combat actions
+  if ( !is_pet() && !is_add() )
+  {
+    execute_precombat_actions();
   }
   first_cast = false;
 
@@ -5834,13 +5911,20 @@ void player_t::datacollection_end()
   // make sure TMI-relevant timeline lengths all match for tanks
   if ( !is_enemy() && !is_pet() && type != HEALING_ENEMY && primary_role() == ROLE_TANK )
   {
-    collected_data.timeline_healing_taken.add( sim->current_time(), 0.0 );
-    collected_data.timeline_dmg_taken.add( sim->current_time(), 0.0 );
+    if ( sim->data_collection == data_collection_level::FULL )
+    {
+      collected_data.timeline_healing_taken.add( sim->current_time(), 0.0 );
+      collected_data.timeline_dmg_taken.add( sim->current_time(), 0.0 );
+    }
     collected_data.health_changes.timeline.add( sim->current_time(), 0.0 );
     collected_data.health_changes.timeline_normalized.add( sim->current_time(), 0.0 );
   }
   collected_data.collect_data( *this );
 
+  // Everything below only feeds the detailed report
+  if ( sim->data_collection < data_collection_level::SUMMARY )
+    return;
+
   range::for_each( buff_list, std::mem_fn( &buff_t::datacollection_end ) );
 
   for ( auto& uptime : uptime_list )
@@ -6083,6 +6167,7 @@ void player_t::merge( player_t& other )
     if ( action_list[ i ]->internal_id == other.action_list[ i ]->internal_id )
     {
       action_list[ i ]->total_executions += other.action_list[ i ]->total_executions;
+      action_list[ i ]->apl_profile.merge( other.action_list[ i ]->apl_profile );
     }
     else
     {
@@ -6526,6 +6611,9 @@ void player_t::arise()
   if ( current.sleeping )
     return;
 
+  // Class modules may set up actor state directly when arising
+  sim->bump_state_generation();
+
   actor_spawn_index = sim->global_spawn_index++;
 
   sim->print_log( "{} arises. Spawn Index={}", *this, actor_spawn_index );
@@ -6997,6 +7085,7 @@ double player_t::resource_loss( resource_e resource_type, double amount, gain_t*
     resources.current[ resource_type ] -= actual_amount;
     iteration_resource_lost[ resource_type ] += actual_amount;
   }
+  sim->bump_state_generation( state_generation::RESOURCE );
 
   if ( source )
   {
@@ -7033,6 +7122,7 @@ double player_t::resource_gain( resource_e resource_type, double amount, gain_t*
   {
     resources.current[ resource_type ] += actual_amount;
     iteration_resource_gained[ resource_type ] += actual_amount;
+    sim->bump_state_generation( state_generation::RESOURCE );
   }
   double overflow_amount = amount - actual_amount;
   if (overflow_amount > 0)
@@ -7114,6 +7204,7 @@ void player_t::recalculate_resource_max( resource_e resource_type, gain_t* sourc
     source->add( resource_type, 0, resources.current[ resource_type ] - resources.max[ resource_type ] );
   }
   resources.current[ resource_type ] = std::min( resources.current[ resource_type ], resources.max[ resource_type ] );
+  sim->bump_state_generation( state_generation::RESOURCE );
 
   sim->print_debug( "Recalculated maximum {} for {}: old={:.2f}/{:.2f}, new={:.2f}/{:.2f}",
                     util::resource_type_string( resource_type ), name(), old_amount, old_max,
@@ -7810,7 +7901,10 @@ void collect_dmg_taken_data( player_t& p, const action_state_t* s, double /* res
   p.iteration_dmg_taken += s->result_amount;
 
   // collect data for timelines
-  p.collected_data.timeline_dmg_taken.add( p.sim->current_time(), s->result_amount );
+  if ( p.sim->data_collection == data_collection_level::FULL )
+  {
+    p.collected_data.timeline_dmg_taken.add( p.sim->current_time(), s->result_amount );
+  }
 
   // tank-specific data storage
   if ( p.collected_data.health_changes.collect )
@@ -8039,7 +8133,10 @@ void player_t::assess_heal( school_e, result_amount_type, action_state_t* s )
   if ( !is_pet() && primary_role() == ROLE_TANK )
   {
     // health_changes and timeline_healing_taken record everything, accounting for overheal and so on
-    collected_data.timeline_healing_taken.add( sim->current_time(), -( s->result_amount ) );
+    if ( sim->data_collection == data_collection_level::FULL )
+    {
+      collected_data.timeline_healing_taken.add( sim->current_time(), -( s->result_amount ) );
+    }
     collected_data.health_changes.timeline.add( sim->current_time(), -( s->result_amount ) );
     double normalized =
         resources.max[ RESOURCE_HEALTH ] ? -( s->result_amount ) / resources.max[ RESOURCE_HEALTH ] : 0.0;
@@ -11234,6 +11331,16 @@ std::unique_ptr<expr_t> player_t::create_expression( util::string_view expressio
 
         double evaluate() override
         { return var_->current_value_; }
+
+        bool load( expression::load_t& l ) const override
+        {
+          l.kind    = expression::load_t::DOUBLE;
+          l.address = &var_->current_value_;
+          return true;
+        }
+
+        unsigned dependencies() const override
+        { return expression::depends_on( state_generation::VARIABLE ); }
       };
 
       return std::make_unique<variable_expr_t>( this, splits[ 1 ] );
@@ -11749,14 +11856,67 @@ std::unique_ptr<expr_t> player_t::create_resource_expression( util::string_view
   if ( r == RESOURCE_NONE )
     return nullptr;
 
+  // Current, maximum and missing amount of a resource other than health, which only change through
+  // the resource methods of the actor
+  struct resource_expr_t : public expr_t
+  {
+    enum kind_e
+    {
+      CURRENT,
+      MAX,
+      DEFICIT
+    };
+
+    const player_t& player;
+    resource_e resource;
+    kind_e kind;
+
+    resource_expr_t( util::string_view name, const player_t& p, resource_e r, kind_e k )
+      : expr_t( name ), player( p ), resource( r ), kind( k )
+    { }
+
+    double evaluate() override
+    {
+      switch ( kind )
+      {
+        case CURRENT: return player.resources.current[ resource ];
+        case MAX:     return player.resources.max[ resource ];
+        default:      return player.resources.max[ resource ] - player.resources.current[ resource ];
+      }
+    }
+
+    bool load( expression::load_t& l ) const override
+    {
+      if ( kind == DEFICIT )
+        return false;
+
+      l.kind    = expression::load_t::DOUBLE;
+      l.address = kind == CURRENT ? &player.resources.current[ resource ] : &player.resources.max[ resource ];
+      return true;
+    }
+
+    unsigned dependencies() const override
+    {
+      return expression::depends_on( state_generation::RESOURCE );
+    }
+  };
+
   if ( splits.size() == 1 )
-    return make_ref_expr( expression_str, resources.current[ r ] );
+  {
+    if ( r == RESOURCE_HEALTH )
+      return make_ref_expr( expression_str, resources.current[ r ] );
+
+    return std::make_unique<resource_expr_t>( expression_str, *this, r, resource_expr_t::CURRENT );
+  }
 
   if ( splits.size() == 2 )
   {
     if ( splits[ 1 ] == "deficit" )
     {
-      return make_fn_expr( expression_str, [ this, r ] { return resources.max[ r ] - resources.current[ r ]; } );
+      if ( r == RESOURCE_HEALTH )
+        return make_fn_expr( expression_str, [ this, r ] { return resources.max[ r ] - resources.current[ r ]; } );
+
+      return std::make_unique<resource_expr_t>( expression_str, *this, r, resource_expr_t::DEFICIT );
     }
 
     else if ( splits[ 1 ] == "pct" || splits[ 1 ] == "percent" )
@@ -11772,7 +11932,12 @@ std::unique_ptr<expr_t> player_t::create_resource_expression( util::string_view
     }
 
     else if ( splits[ 1 ] == "max" )
-      return make_ref_expr( expression_str, resources.max[ r ] );
+    {
+      if ( r == RESOURCE_HEALTH )
+        return make_ref_expr( expression_str, resources.max[ r ] );
+
+      return std::make_unique<resource_expr_t>( expression_str, *this, r, resource_expr_t::MAX );
+    }
 
     else if ( splits[ 1 ] == "max_nonproc" )
       return make_ref_expr( expression_str, collected_data.buffed_stats_snapshot.resource[ r ] );
@@ -12903,13 +13068,13 @@ void player_t::analyze( sim_t& s )
   range::for_each( sample_data_list, []( sample_data_helper_t* sd ) { sd->analyze(); } );
 
   // Pet Chart Adjustment ===================================================
-  size_t max_buckets = static_cast<size_t>( collected_data.fight_length.max() );
+  size_t max_buckets = static_cast<size_t>( collected_data.fight_length.max() / sim->timeline_bin_size );
 
   // Make the pet graphs the same length as owner's
   if ( is_pet() )
   {
     player_t* o = cast_pet()->owner;
-    max_buckets = static_cast<size_t>( o->collected_data.fight_length.max() );
+    max_buckets = static_cast<size_t>( o->collected_data.fight_length.max() / sim->timeline_bin_size );
   }
 
   // Stats Analysis =========================================================
@@ -13427,6 +13592,13 @@ player_collected_data_t::player_collected_data_t( const player_t* player ) :
 
 void player_collected_data_t::reserve_memory( const player_t& p )
 {
+  // Fight length samples are kept as-is, single actor batch timelines are adjusted with them
+  for ( auto sd : { &dmg, &compound_dmg, &dps, &prioritydps, &dpse, &dtps, &dmg_taken, &heal, &compound_heal,
+                    &hps, &hpse, &htps, &heal_taken, &absorb, &compound_absorb, &aps, &atps, &absorb_taken, &deaths } )
+  {
+    sd->change_sketch( p.sim->statistics_sketch );
+  }
+
   unsigned size = std::min( as<unsigned>( p.sim->iterations ), 2048U );
   fight_length.reserve( size );
   // DMG
@@ -13445,6 +13617,23 @@ void player_collected_data_t::reserve_memory( const player_t& p )
   heal_taken.reserve( size );
   deaths.reserve( size );
 
+  // Timelines are sized for the expected fight length up front, longer fights still extend them.
+  // Resource timelines are created later, in init_resources().
+  if ( p.sim->data_collection == data_collection_level::FULL )
+  {
+    auto max_time = timespan_t::from_seconds( p.sim->expected_max_time() );
+    for ( auto tl : { &timeline_dmg, &timeline_dmg_taken, &timeline_healing_taken, &health_pct } )
+    {
+      tl->set_bin_size( p.sim->timeline_bin_size );
+      tl->reserve( max_time );
+    }
+    for ( auto& tl : stat_timelines )
+    {
+      tl.timeline.set_bin_size( p.sim->timeline_bin_size );
+      tl.timeline.reserve( max_time );
+    }
+  }
+
   if ( !p.is_pet() && p.primary_role() == ROLE_TANK && p.type != PLAYER_SIMPLIFIED )
     p.sim->num_tanks++;
   }
@@ -13546,6 +13735,8 @@ void player_collected_data_t::analyze( const player_t& p )
   atps.analyze();
   // Tank
   deaths.analyze();
+  // Convergence checks only read the running moments of the target metric
+  target_metric.analyze();
 
   if ( !p.sim->single_actor_batch )
   {
@@ -13731,26 +13922,37 @@ action_t* player_t::select_action( const action_priority_list_t& list,
   size_t attempted_random = 0;
 
   util::span<action_t* const> a_list;
+  util::span<const timespan_t> ready_at;
   switch ( et )
   {
     case execute_type::OFF_GCD:
       a_list = list.off_gcd_actions;
+      ready_at = list.off_gcd_ready_at;
       break;
     case execute_type::CAST_WHILE_CASTING:
       a_list = list.cast_while_casting_actions;
+      ready_at = list.cast_while_casting_ready_at;
       break;
     default:
       a_list = list.foreground_action_list;
+      ready_at = list.foreground_ready_at;
       break;
   }
 
-  for ( action_t* a : a_list )
+  // Readiness index, skips entries whose cooldowns do not allow them to be ready yet
+  bool use_index = !ready_at.empty() && ready_at.size() == a_list.size();
+
+  for ( size_t i = 0; i < a_list.size(); ++i )
   {
+    action_t* a = a_list[ i ];
+    bool randomized = false;
+
     visited_apls_ = _visited;
 
     if ( list.random == 1 )
     {
       a = rng().range( a_list );
+      randomized = true;
     }
     else
     {
@@ -13759,6 +13961,7 @@ action_t* player_t::select_action( const action_priority_list_t& list,
       {
         size_t max_random_attempts = static_cast<size_t>( a_list.size() * ( skill * 0.5 ) );
         a = rng().range( a_list );
+        randomized = true;
         attempted_random++;
         // Limit the amount of attempts to select a random action based on skill, then bail out and try again in 100
         // ms.
@@ -13772,13 +13975,22 @@ action_t* player_t::select_action( const action_priority_list_t& list,
       return nullptr;
     }
 
+    if ( use_index && !randomized && ready_at[ i ] > sim->current_time() )
+    {
+      if ( sim->apl_profile && !a->background )
+      {
+        a->apl_profile.reject( ready_failure::COOLDOWN );
+      }
+      continue;
+    }
+
     if ( a->background )
       continue;
 
     if ( a->option.wait_on_ready == 1 )
       break;
 
-    if ( a->action_ready() )
+    if ( sim->apl_profile ? a->profile_action_ready() : a->action_ready() )
     {
       // Execute variable operation, and continue processing
       if ( a->type == ACTION_VARIABLE )
@@ -14091,6 +14303,36 @@ void player_t::update_cast_while_casting_ready()
   schedule_cwc_ready();
 }
 
+// Build the readiness index of all action priority lists. Each entry is registered with the
+// cooldown and internal cooldown of its action, which keep it up to date. Entries with
+// wait_on_ready=1 stop the action selection, so they are never skipped.
+void player_t::init_readiness_index()
+{
+  auto build = []( const std::vector<action_t*>& actions, std::vector<timespan_t>& ready_at ) {
+    ready_at.assign( actions.size(), timespan_t::min() );
+    for ( size_t i = 0; i < actions.size(); ++i )
+    {
+      action_t* a = actions[ i ];
+      if ( a->option.wait_on_ready == 1 )
+      {
+        continue;
+      }
+
+      cooldown_readiness_entry_t entry{ &ready_at[ i ], a->cooldown, a->internal_cooldown };
+      a->cooldown->readiness_entries.push_back( entry );
+      a->internal_cooldown->readiness_entries.push_back( entry );
+      entry.update();
+    }
+  };
+
+  for ( auto apl : action_priority_list )
+  {
+    build( apl->foreground_action_list, apl->foreground_ready_at );
+    build( apl->off_gcd_actions, apl->off_gcd_ready_at );
+    build( apl->cast_while_casting_actions, apl->cast_while_casting_ready_at );
+  }
+}
+
 /**
  * Verify that the user input (APL) contains an use-item line for all on-use items
  */
@@ -326,6 +326,9 @@ struct player_t : public actor_t
   auto_dispose< std::vector<dot_t*> > dot_list;
   auto_dispose< std::vector<action_priority_list_t*> > action_priority_list;
   std::vector<action_t*> precombat_action_list;
+  // Precombat action decisions ( actions and targets ) of the first iteration, see sim_t::precombat_decision_cache
+  enum precombat_decisions_e { PRECOMBAT_EVALUATE, PRECOMBAT_RECORD, PRECOMBAT_CACHED } precombat_decisions;
+  std::vector<std::pair<action_t*, player_t*>> precombat_decision_list;
   action_priority_list_t* active_action_list;
   action_priority_list_t* default_action_list;
   action_priority_list_t* active_off_gcd_list;
@@ -1137,6 +1140,7 @@ public:
   virtual void combat_begin();
   virtual void combat_end();
   virtual void precombat_init();
+  void execute_precombat_actions();
   virtual void merge( player_t& other );
   virtual void datacollection_begin();
   virtual void datacollection_end();
@@ -1484,6 +1488,7 @@ public:
 
   void update_off_gcd_ready();
   void update_cast_while_casting_ready();
+  void init_readiness_index();
 
   // Stuff, testing
   std::vector<spawner::base_actor_spawner_t*> spawners;
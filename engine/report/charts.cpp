@@ -1642,6 +1642,7 @@ highchart::time_series_t& chart::generate_stats_timeline(
 
   ts.add_simple_series( "area", area_color, s.type == STATS_DMG ? "DPS" : "HPS",
                         timeline_aps.data() );
+  ts.set_bin_size( timeline_aps.bin_size() );
   ts.set_mean(
       util::round( s.portion_aps.mean(), s.player->sim->report_precision ) );
 
@@ -1666,6 +1667,7 @@ bool chart::generate_actor_dps_series( highchart::time_series_t& series, const p
   series.set_yaxis_title( "Damage per second" );
   series.set_title( util::encode_html( p.name_str ) + " Damage per second" );
   series.add_simple_series( "area", color::class_color( p.type ), "DPS", timeline_dps.data() );
+  series.set_bin_size( timeline_dps.bin_size() );
   series.set_mean( util::round( p.collected_data.dps.mean(), p.sim->report_precision ) );
 
   return true;
@@ -1685,6 +1687,7 @@ highchart::time_series_t& chart::generate_actor_timeline(
   ts.set_title( util::encode_html( p.name_str ) + " " + attr_str );
   ts.set_yaxis_title( "Average " + attr_str );
   ts.add_simple_series( "area", series_color, attr_str, data.data() );
+  ts.set_bin_size( data.bin_size() );
   if ( !p.sim->single_actor_batch )
   {
     ts.set_xaxis_max( p.sim->simulation_length.max() );
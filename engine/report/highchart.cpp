@@ -460,6 +460,17 @@ time_series_t& time_series_t::set_mean( double value_,
   return *this;
 }
 
+// Time between consecutive points of simple series, for timelines with bins other than one second
+time_series_t& time_series_t::set_bin_size( double seconds )
+{
+  if ( seconds != 1 )
+  {
+    set( "plotOptions.series.pointInterval", seconds );
+  }
+
+  return *this;
+}
+
 time_series_t& time_series_t::set_max( double value_, std::optional<color::rgb> color )
 {
   if ( !color.has_value() )
@@ -100,6 +100,7 @@ public:
 
   time_series_t& set_mean( double value_, std::optional<color::rgb> color = {} );
   time_series_t& set_max( double value_, std::optional<color::rgb> color = {} );
+  time_series_t& set_bin_size( double seconds );
 };
 
 struct bar_chart_t : public chart_t
@@ -237,6 +237,36 @@ void procs_to_json( JsonOutput root, const player_t& p )
   } );
 }
 
+void apl_profile_to_json( JsonOutput root, const player_t& p )
+{
+  const auto& sim = *p.sim;
+  double iterations = sim.single_actor_batch ? p.collected_data.total_iterations + sim.threads : sim.iterations;
+
+  root.make_array();
+  range::for_each( p.action_list, [ & ]( const action_t* a ) {
+    const auto& profile = a->apl_profile;
+    if ( profile.evaluations == 0 || !a->action_list || !a->signature )
+    {
+      return;
+    }
+
+    auto node = root.add();
+    node[ "action_list" ] = a->action_list->name_str;
+    node[ "entry" ] = a->signature->action_;
+    node[ "name" ] = a->name();
+    node[ "evaluations" ] = profile.evaluations / iterations;
+    node[ "successes" ] = profile.successes / iterations;
+    node[ "pass_rate" ] = profile.pass_rate();
+    for ( unsigned i = static_cast<unsigned>( ready_failure::COOLDOWN ); i < static_cast<unsigned>( ready_failure::MAX ); ++i )
+    {
+      auto f = static_cast<ready_failure>( i );
+      add_non_zero( node[ "rejection_rate" ], util::ready_failure_string( f ), profile.rejection_rate( f ) );
+    }
+    node[ "cpu_time_per_evaluation" ] = profile.cpu_time_per_evaluation();
+    node[ "cpu_time" ] = profile.total_cpu_time();
+  } );
+}
+
 bool has_valid_stats( const std::vector<stats_t*>& stats_list, int level = 0 )
 {
   return range::any_of( stats_list, [ level ]( const stats_t* stats ) {
@@ -676,6 +706,11 @@ void collected_data_to_json( JsonOutput root, const ::report::json::report_confi
     {
       to_json( root[ "action_sequence" ], report_configuration, cd.action_sequence, relevant_resources );
     }
+
+    if ( sim.apl_profile )
+    {
+      apl_profile_to_json( root[ "apl_profile" ], p );
+    }
   }
 }
 
@@ -1021,6 +1056,19 @@ void profileset_json2( const profileset::profilesets_t& profileset, const sim_t&
 
                      obj[ "iterations" ] = as<uint64_t>( result.iterations() );
 
+                     if ( result.paired_iterations() > 0 )
+                     {
+                       obj[ "paired_delta" ] = result.paired_delta();
+                       obj[ "paired_delta_error" ] = result.paired_delta_stddev() * sim.confidence_estimator;
+                       obj[ "paired_iterations" ] = as<uint64_t>( result.paired_iterations() );
+                     }
+
+                     // Dropped by profileset racing, mean_error is the error of the last round simulated
+                     if ( profileset->pruned() )
+                     {
+                       obj[ "pruned" ] = true;
+                     }
+
                      if ( profileset->results() > 1 )
                      {
                        auto results2 = obj[ "additional_metrics" ].make_array();
@@ -1065,6 +1113,10 @@ void profileset_json3( const profileset::profilesets_t& profilesets, const sim_t
                    [ &results, &sim ]( const profileset::profilesets_t::profileset_entry_t& profileset ) {
                      auto&& obj = results.add();
                      obj[ "name" ] = profileset->name();
+                     if ( profileset->pruned() )
+                     {
+                       obj[ "pruned" ] = true;
+                     }
                      auto results_obj = obj[ "metrics" ].make_array();
 
                      for ( size_t midx = 0; midx < sim.profileset_metric.size(); ++midx )
@@ -1089,6 +1141,13 @@ void profileset_json3( const profileset::profilesets_t& profilesets, const sim_t
                        }
 
                        obj[ "iterations" ] = as<uint64_t>( result.iterations() );
+
+                       if ( result.paired_iterations() > 0 )
+                       {
+                         obj[ "paired_delta" ] = result.paired_delta();
+                         obj[ "paired_delta_error" ] = result.paired_delta_stddev() * sim.confidence_estimator;
+                         obj[ "paired_iterations" ] = as<uint64_t>( result.paired_iterations() );
+                       }
                      }
 
                      // Optional override ouput data
@@ -1193,6 +1252,10 @@ void to_json( const ::report::json::report_configuration_t& report_configuration
   options_root[ "target_error" ] = sim.target_error;
   options_root[ "threads" ] = sim.threads;
   options_root[ "seed" ] = sim.seed;
+  if ( sim.counter_rng )
+  {
+    options_root[ "counter_rng_key" ] = sim.counter_rng_key;
+  }
   options_root[ "single_actor_batch" ] = sim.single_actor_batch;
   options_root[ "queue_lag" ] = sim.queue_lag.mean;
   options_root[ "queue_lag_stddev" ] = sim.queue_lag.stddev;
@@ -1299,7 +1362,15 @@ void to_json( const ::report::json::report_configuration_t& report_configuration
   stats_root[ "elapsed_cpu_seconds" ] = chrono::to_fp_seconds( sim.elapsed_cpu );
   stats_root[ "elapsed_time_seconds" ] = chrono::to_fp_seconds( sim.elapsed_time );
   stats_root[ "init_time_seconds" ] = chrono::to_fp_seconds( sim.init_time );
+  stats_root[ "spinup_time_seconds" ] = chrono::to_fp_seconds( sim.spinup_time );
   stats_root[ "merge_time_seconds" ] = chrono::to_fp_seconds( sim.merge_time );
+  if ( !sim.merge_round_time.empty() )
+  {
+    auto rounds_root = stats_root[ "merge_round_time_seconds" ].make_array();
+    range::for_each( sim.merge_round_time, [ &rounds_root ]( const auto& t ) {
+      rounds_root.add( chrono::to_fp_seconds( t ) );
+    } );
+  }
   stats_root[ "analyze_time_seconds" ] = chrono::to_fp_seconds( sim.analyze_time );
   stats_root[ "simulation_length" ] = sim.simulation_length;
   stats_root[ "total_events_processed" ] = sim.event_mgr.total_events_processed;
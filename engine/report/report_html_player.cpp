@@ -2513,6 +2513,65 @@ void print_html_player_action_priority_list( report::sc_html_stream& os, const p
     os << "</table>\n";
   }
 
+  // APL Profile
+
+  if ( sim.apl_profile )
+  {
+    double iterations = sim.single_actor_batch ? p.collected_data.total_iterations + sim.threads : sim.iterations;
+    double total_cpu_time = 0;
+    for ( const action_t* a : p.action_list )
+    {
+      total_cpu_time += a->apl_profile.total_cpu_time();
+    }
+
+    os << "<div class=\"subsection subsection-small\">\n"
+       << "<h4>APL Profile</h4>\n"
+       << "<table class=\"sc even\">\n"
+       << "<thead>\n"
+       << "<tr>\n"
+       << "<th class=\"left\">action list</th>\n"
+       << "<th class=\"left\">action</th>\n"
+       << "<th class=\"right\">evaluations</th>\n"
+       << "<th class=\"right\">pass</th>\n";
+    for ( unsigned i = static_cast<unsigned>( ready_failure::COOLDOWN ); i < static_cast<unsigned>( ready_failure::MAX ); ++i )
+    {
+      os.format( "<th class=\"right\">{}</th>\n", util::ready_failure_string( static_cast<ready_failure>( i ) ) );
+    }
+    os << "<th class=\"right\">ns/eval</th>\n"
+       << "<th class=\"right\">cpu</th>\n"
+       << "</tr>\n"
+       << "</thead>\n";
+
+    for ( const action_t* a : p.action_list )
+    {
+      const auto& profile = a->apl_profile;
+      if ( profile.evaluations == 0 || !a->action_list || !a->signature )
+        continue;
+
+      os.format( "<tr>\n"
+                 "<td class=\"left\">{}</td>\n"
+                 "<td class=\"left\">{}</td>\n"
+                 "<td class=\"right\">{:.1f}</td>\n"
+                 "<td class=\"right\">{:.1f}%</td>\n",
+                 util::encode_html( a->action_list->name_str ),
+                 util::encode_html( a->signature->action_ ),
+                 profile.evaluations / iterations,
+                 profile.pass_rate() * 100.0 );
+      for ( unsigned i = static_cast<unsigned>( ready_failure::COOLDOWN ); i < static_cast<unsigned>( ready_failure::MAX ); ++i )
+      {
+        os.format( "<td class=\"right\">{:.1f}%</td>\n", profile.rejection_rate( static_cast<ready_failure>( i ) ) * 100.0 );
+      }
+      os.format( "<td class=\"right\">{:.0f}</td>\n"
+                 "<td class=\"right\">{:.1f}%</td>\n"
+                 "</tr>\n",
+                 profile.cpu_time_per_evaluation() * 1e9,
+                 total_cpu_time > 0 ? profile.total_cpu_time() / total_cpu_time * 100.0 : 0.0 );
+    }
+
+    os << "</table>\n"
+       << "</div>\n";
+  }
+
   // Sample Sequences
 
   if ( !p.collected_data.action_sequence.empty() && !p.is_enemy()  )
@@ -3139,6 +3198,7 @@ void print_html_player_charts( report::sc_html_stream& os, const player_t& p,
     dps_taken.set_yaxis_title( "Damage taken per second" );
     dps_taken.set_title( util::encode_html( p.name_str ) + " Damage taken per second" );
     dps_taken.add_simple_series( "area", color::rgb{"FDD017"}, "DPS taken", timeline_dps_taken.data() );
+    dps_taken.set_bin_size( timeline_dps_taken.bin_size() );
     dps_taken.set_mean( timeline_dps_taken.mean() );
 
     if ( p.sim->player_no_pet_list.size() > 1 )
@@ -630,7 +630,7 @@ void print_waiting_all( std::ostream& os, const sim_t& sim )
 
 void print_iteration_data( std::ostream& os, const sim_t& sim )
 {
-  if ( !sim.deterministic || sim.report_iteration_data == 0 )
+  if ( !( sim.deterministic || sim.counter_rng ) || sim.report_iteration_data == 0 )
   {
     return;
   }
@@ -641,6 +641,11 @@ void print_iteration_data( std::ostream& os, const sim_t& sim )
   std::string spacer_str_2( n_spacer, ' ' );
 
   fmt::print( os, "\nIteration data:\n" );
+  if ( sim.counter_rng )
+  {
+    fmt::print( os, "  Counter RNG key: {} (replay with iterations=1 counter_rng=1 counter_rng_iteration=<Iter#> seed={})\n",
+        sim.counter_rng_key, sim.counter_rng_key );
+  }
   if ( !sim.low_iteration_data.empty() && !sim.high_iteration_data.empty() )
   {
     fmt::print(
@@ -743,6 +748,26 @@ void sim_summary_performance( std::ostream& os, sim_t* sim )
   if ( sim -> threads > 1 )
     iterations_str = fmt::format( " ({})", fmt::join( sim -> work_per_thread, ", " ) );
 
+  // Per size class event blocks allocated (requests served)
+  std::vector<std::string> event_blocks;
+  for ( unsigned i = 0; i < EVENT_SIZE_CLASSES; ++i )
+  {
+    const auto& size_class = sim->event_mgr.size_classes[ i ];
+    event_blocks.push_back( fmt::format( "{}b:{} ({})", event_size_class_size( i ), size_class.allocated,
+                                         size_class.requested ) );
+  }
+  std::string event_block_str = util::string_join( event_blocks, " " );
+
+  std::string merge_rounds_str;
+  if ( !sim->merge_round_time.empty() )
+  {
+    std::vector<std::string> rounds;
+    range::transform( sim->merge_round_time, std::back_inserter( rounds ), []( const auto& t ) {
+      return fmt::format( "{:.3f}", chrono::to_fp_seconds( t ) );
+    } );
+    merge_rounds_str = fmt::format( " (rounds: {})", util::string_join( rounds, ", " ) );
+  }
+
   fmt::print(
       os,
       "\n\nBaseline Performance:\n"
@@ -751,6 +776,8 @@ void sim_summary_performance( std::ostream& os, sim_t* sim )
       "  Iterations    = {}{}\n"
       "  TotalEvents   = {}\n"
       "  MaxEventQueue = {}\n"
+      "  EventQueue    = {}\n"
+      "  EventBlocks   = {}\n"
 #ifdef EVENT_QUEUE_DEBUG
       "  AllocEvents   = {}\n"
       "  EndInsert     = {} ({:.3f}%)\n"
@@ -762,7 +789,8 @@ void sim_summary_performance( std::ostream& os, sim_t* sim )
       "  CpuSeconds    = {}\n"
       "  WallSeconds   = {}\n"
       "  InitSeconds   = {}\n"
-      "  MergeSeconds  = {}\n"
+      "  SpinUpSeconds = {}\n"
+      "  MergeSeconds  = {}{}\n"
       "  AnalyzeSeconds= {}\n"
       "  SpeedUp       = {:.0f}\n"
       "  EndTime       = {:%Y-%m-%d %H:%M:%S%z} ({})\n\n",
@@ -772,6 +800,8 @@ void sim_summary_performance( std::ostream& os, sim_t* sim )
       sim -> threads > 1 ? iterations_str : "",
       sim->event_mgr.total_events_processed,
       sim->event_mgr.max_events_remaining,
+      event_queue_type_string( sim->event_mgr.queue_type ),
+      event_block_str,
 #ifdef EVENT_QUEUE_DEBUG
       sim->event_mgr.n_allocated_events, sim->event_mgr.n_end_insert,
       100.0 * static_cast<double>( sim->event_mgr.n_end_insert ) /
@@ -784,7 +814,9 @@ void sim_summary_performance( std::ostream& os, sim_t* sim )
       sim->simulation_length.sum(), chrono::to_fp_seconds(sim->elapsed_cpu),
       chrono::to_fp_seconds(sim->elapsed_time),
       chrono::to_fp_seconds(sim->init_time),
+      chrono::to_fp_seconds(sim->spinup_time),
       chrono::to_fp_seconds(sim->merge_time),
+      merge_rounds_str,
       chrono::to_fp_seconds(sim->analyze_time),
       sim->iterations * sim->simulation_length.mean() / chrono::to_fp_seconds(sim->elapsed_cpu),
       fmt::localtime(cur_time), cur_time );
@@ -836,8 +868,12 @@ void sim_summary_performance( std::ostream& os, sim_t* sim )
   fmt::print( os, "Total: {:.3f}% Alloc Samples: {}\n",
       total_p,
       sim->event_mgr.n_requested_events );
-  fmt::print( os, "Alloc size used for event_t: {}\n",
-      util::next_power_of_two( 2 * sizeof( event_t ) ) );
+  fmt::print( os, "Alloc size classes used for event_t:" );
+  for ( unsigned i = 0; i < EVENT_SIZE_CLASSES; ++i )
+  {
+    fmt::print( os, " {}", event_size_class_size( i ) );
+  }
+  fmt::print( os, "\n" );
 #endif
 }
 
@@ -1232,8 +1268,19 @@ void print_profilesets( std::ostream& out, const profileset::profilesets_t& prof
 
   auto results = profilesets.generate_sorted_profilesets();
 
-  range::for_each( results, [ &out ]( const profileset::profile_set_t* profileset ) {
-    fmt::print( out, "    {:-10.3f} : {:s}\n", profileset->result().median(), profileset->name() );
+  range::for_each( results, [ &out, &sim ]( const profileset::profile_set_t* profileset ) {
+    const auto& result = profileset->result();
+    fmt::print( out, "    {:-10.3f} : {:s}", result.median(), profileset->name() );
+    if ( result.paired_iterations() > 0 )
+    {
+      fmt::print( out, " (paired delta={:+.3f} error={:.3f})", result.paired_delta(),
+                  result.paired_delta_stddev() * sim.confidence_estimator );
+    }
+    if ( profileset->pruned() )
+    {
+      fmt::print( out, " (pruned, error={:.3f})", result.mean_stddev() * sim.confidence_estimator );
+    }
+    fmt::print( out, "\n" );
   } );
 }
 
@@ -29,6 +29,45 @@ enum class profile_source
   BLIZZARD_API
 };
 
+// Amount of per-iteration data collected for reporting, in increasing order
+enum class data_collection_level : int
+{
+  // FULL, except METRIC for profileset, scale factor and plot sims
+  AUTO = -1,
+
+  // Actor collected data only (dps, hps, dtps, ...), enough for the target metric
+  METRIC = 0,
+
+  // Per-iteration ability, buff, proc, benefit, uptime and sample statistics, no timelines
+  SUMMARY,
+
+  // Everything, including timelines
+  FULL
+};
+
+// Reason of a failed action_ready() check, recorded by the APL profiler
+enum class ready_failure : unsigned
+{
+  NONE = 0u,
+  COOLDOWN,   // Cooldown, internal cooldown or line cooldown not ready
+  RESOURCE,   // Not enough resources
+  TARGET,     // No valid target, or no target satisfying target_if
+  EXPRESSION, // if expression false
+  OTHER,      // Class module specific, movement, sync action, ...
+  MAX
+};
+
+// Simulation state tracked by generation counters for expression memoization
+enum class state_generation : unsigned
+{
+  BUFF = 0u,
+  COOLDOWN,
+  RESOURCE,
+  DOT,
+  VARIABLE,
+  MAX
+};
+
 // Attack power computation modes for Battle for Azeroth+
 enum class attack_power_type : unsigned
 {
@@ -238,6 +238,20 @@ struct special_effect_initializer_t
   { unique_gear::unregister_special_effects(); }
 };
 
+// RAII-wrapper for the worker thread pool shared by all phases of the simulation
+struct thread_pool_initializer_t
+{
+  thread_pool_initializer_t( sim_t* sim ) :
+    _sim( sim ), _pool( as<unsigned>( std::max( 0, sim->threads ) ), sim->thread_pinning )
+  { _sim->thread_pool = &_pool; }
+
+  ~thread_pool_initializer_t()
+  { _sim->thread_pool = nullptr; }
+private:
+  sim_t* _sim;
+  thread_pool_t _pool;
+};
+
 void print_version_info( const dbc_t& dbc )
 {
   fmt::print( "{}", util::version_info_str( &dbc ) );
@@ -352,6 +366,9 @@ int sim_t::main( const std::vector<std::string>& args )
           "vary_combat_length={:0.2f}, optimal_raid={}, fight_style={} )\n\n",
           iterations, threads, target_error, max_time.total_seconds(), vary_combat_length, optimal_raid, fight_style );
 
+      // Baseline, scale factor, plot and profileset sims all run their threads on the same pool
+      thread_pool_initializer_t thread_pool_init( this );
+
       progress_bar.set_base( "Baseline" );
       if ( execute() )
       {
@@ -12,6 +12,38 @@
 
 namespace { // UNNAMED NAMESPACE
 
+// Cooldown readiness expressions, which compiled expressions can read directly
+struct cooldown_ready_expr_t : public expr_t
+{
+  const cooldown_t& cooldown;
+  expression::load_t::kind_e kind;
+
+  cooldown_ready_expr_t( util::string_view n, const cooldown_t& cd, expression::load_t::kind_e k ) :
+    expr_t( n ), cooldown( cd ), kind( k )
+  { }
+
+  double evaluate() override
+  {
+    if ( kind == expression::load_t::REMAINS )
+      return cooldown.remains().total_seconds();
+
+    return cooldown.up();
+  }
+
+  bool load( expression::load_t& l ) const override
+  {
+    l.kind    = kind;
+    l.address = &cooldown.ready;
+    l.now     = &cooldown.sim.event_mgr.current_time;
+    return true;
+  }
+
+  unsigned dependencies() const override
+  {
+    return expression::depends_on( state_generation::COOLDOWN );
+  }
+};
+
 struct recharge_event_t : event_t
 {
   cooldown_t* cooldown_;
@@ -355,6 +387,13 @@ void cooldown_t::reset_init()
 
   recharge_event = nullptr;
   ready_trigger_event = nullptr;
+
+  for ( const auto& entry : readiness_entries )
+  {
+    entry.update();
+  }
+
+  sim.bump_state_generation( state_generation::COOLDOWN );
 }
 
 void cooldown_t::reset( bool require_reaction, int charges_ )
@@ -518,7 +557,7 @@ timespan_t cooldown_t::cooldown_duration( const cooldown_t* cd )
 std::unique_ptr<expr_t> cooldown_t::create_expression( std::string_view name )
 {
   if ( name == "remains" )
-    return make_mem_fn_expr( "cooldown_remains", *this, &cooldown_t::remains );
+    return std::make_unique<cooldown_ready_expr_t>( "cooldown_remains", *this, expression::load_t::REMAINS );
   else if ( name == "base_duration" )
   {
     return make_fn_expr( "cooldown_base_duration", [ this ]
@@ -539,7 +578,7 @@ std::unique_ptr<expr_t> cooldown_t::create_expression( std::string_view name )
     } );
   }
   else if ( name == "up" || name == "ready" )
-    return make_mem_fn_expr( "cooldown_up", *this, &cooldown_t::up );
+    return std::make_unique<cooldown_ready_expr_t>( "cooldown_up", *this, expression::load_t::PASSED );
   else if ( name == "charges" )
   {
     return make_fn_expr( name, [ this ]
@@ -626,6 +665,13 @@ std::unique_ptr<expr_t> cooldown_t::create_expression( std::string_view name )
 
 void cooldown_t::update_ready_thresholds()
 {
+  for ( const auto& entry : readiness_entries )
+  {
+    entry.update();
+  }
+
+  sim.bump_state_generation( state_generation::COOLDOWN );
+
   if ( player == nullptr )
   {
     return;
@@ -647,6 +693,18 @@ timespan_t cooldown_t::queueable() const
   return ready - player->cooldown_tolerance();
 }
 
+// Mirrors the cooldown and internal cooldown checks of action_t::ready()
+void cooldown_readiness_entry_t::update() const
+{
+  timespan_t cooldown_ready = cooldown->ready;
+  if ( cooldown->action && cooldown->player )
+  {
+    cooldown_ready = std::min( cooldown_ready, cooldown->queueable() );
+  }
+
+  *ready_at = std::max( cooldown_ready, internal_cooldown->ready );
+}
+
 double cooldown_t::charges_fractional() const
 {
   if ( charges > 1 )
@@ -16,6 +16,7 @@
 #include <memory>
 
 struct action_t;
+struct cooldown_t;
 struct event_t;
 struct expr_t;
 struct player_t;
@@ -23,6 +24,18 @@ struct sim_t;
 
 // Cooldown =================================================================
 
+// Entry of an action priority list readiness index (sim option apl_readiness_index). Holds the
+// earliest time at which the cooldown and internal cooldown of an APL line allow it to be ready,
+// and is updated by both cooldowns whenever they change.
+struct cooldown_readiness_entry_t
+{
+  timespan_t* ready_at;
+  const cooldown_t* cooldown;
+  const cooldown_t* internal_cooldown;
+
+  void update() const;
+};
+
 struct cooldown_t
 {
   sim_t& sim;
@@ -49,6 +62,9 @@ struct cooldown_t
   double recharge_multiplier;
   timespan_t base_duration;
 
+  // Action priority list readiness index entries depending on this cooldown
+  std::vector<cooldown_readiness_entry_t> readiness_entries;
+
   cooldown_t( util::string_view name, player_t& );
   cooldown_t( util::string_view name, sim_t& );
 
@@ -39,7 +39,8 @@ constexpr unsigned next_power_of_two( unsigned v )
 // as such there are rules of use that must be honored:
 //
 // (1) The pure virtual execute() method MUST be implemented in the sub-class
-// (2) There is 1 * sizeof( event_t ) space available to extend the sub-class
+// (2) Sub-classes are allocated from power-of-two size classes, the largest
+//     one leaves 7 * sizeof( event_t ) space available to extend the sub-class
 // (3) event_manager_t is responsible for deleting the memory associated with allocated events
 // (4) create events through make_event method
 struct event_t : private noncopyable
@@ -52,6 +53,7 @@ struct event_t : private noncopyable
   bool        canceled;
   bool        recycled;
   bool scheduled;
+  uint8_t     size_class;
 #ifdef ACTOR_EVENT_BOOKKEEPING
   actor_t*    actor;
 #endif
@@ -107,6 +109,27 @@ protected:
   static void* operator new( std::size_t ) = delete; // NOLINT(modernize-use-equals-delete)
 };
 
+// Event allocation size classes, see event_manager_t::allocate_event
+constexpr unsigned EVENT_SIZE_CLASSES = 3;
+
+/// Block size of an event allocation size class
+constexpr std::size_t event_size_class_size( unsigned size_class )
+{
+  return std::size_t( util::next_power_of_two( 2 * sizeof( event_t ) ) ) << size_class;
+}
+
+/// Smallest size class that fits an event of the given size
+constexpr unsigned event_size_class( std::size_t size )
+{
+  unsigned size_class = 0;
+  while ( size_class < EVENT_SIZE_CLASSES - 1 && size > event_size_class_size( size_class ) )
+  {
+    size_class++;
+  }
+
+  return size_class;
+}
+
 /**
  * @brief Creates a event
  *
@@ -120,7 +143,7 @@ inline Event* make_event( sim_t& sim, Args&&... args )
 {
   static_assert( std::is_base_of<event_t, Event>::value,
                  "Event must be derived from event_t" );
-  static_assert( sizeof( Event ) <= util::next_power_of_two( 2 * sizeof( event_t ) ),
+  static_assert( sizeof( Event ) <= event_size_class_size( EVENT_SIZE_CLASSES - 1 ),
                  "Event type is too big" );
   auto r = new ( sim ) Event( std::forward<Args>(args)... );
   assert( r -> id != 0 && "Event not added to event manager!" );
@@ -9,6 +9,222 @@
 #include "sim/sim.hpp"
 #include "player/player.hpp"
 
+#if defined( _MSC_VER ) && defined( _M_X64 )
+#include <intrin.h>
+#endif
+
+namespace
+{
+/// Index of the lowest set bit of a non-zero value
+unsigned lowest_set_bit( uint64_t v )
+{
+  assert( v != 0 );
+#if defined( _MSC_VER ) && defined( _M_X64 )
+  unsigned long idx;
+  _BitScanForward64( &idx, v );
+  return static_cast<unsigned>( idx );
+#elif defined( __GNUC__ ) || defined( __clang__ )
+  return static_cast<unsigned>( __builtin_ctzll( v ) );
+#else
+  unsigned idx = 0;
+  while ( !( v & 1 ) )
+  {
+    v >>= 1;
+    idx++;
+  }
+  return idx;
+#endif
+}
+
+constexpr unsigned level_shift( unsigned level )
+{
+  return level == 0 ? 0 : hierarchical_wheel_t::LEVEL0_BITS + ( level - 1 ) * hierarchical_wheel_t::LEVEL_BITS;
+}
+
+constexpr unsigned level_bits( unsigned level )
+{
+  return level == 0 ? hierarchical_wheel_t::LEVEL0_BITS : hierarchical_wheel_t::LEVEL_BITS;
+}
+
+constexpr uint64_t level_mask( unsigned level )
+{
+  return ( uint64_t( 1 ) << level_bits( level ) ) - 1;
+}
+}  // namespace
+
+const char* event_queue_type_string( event_queue_e type )
+{
+  switch ( type )
+  {
+    case event_queue_e::TIMING_WHEEL:       return "timing_wheel";
+    case event_queue_e::HIERARCHICAL_WHEEL: return "hierarchical_wheel";
+    default:                                return "unknown";
+  }
+}
+
+event_queue_e parse_event_queue_type( util::string_view name )
+{
+  if ( util::str_compare_ci( name, "timing_wheel" ) )
+    return event_queue_e::TIMING_WHEEL;
+  if ( util::str_compare_ci( name, "hierarchical_wheel" ) )
+    return event_queue_e::HIERARCHICAL_WHEEL;
+
+  throw std::invalid_argument(
+      fmt::format( "Unknown event queue '{}', valid values are 'timing_wheel' and 'hierarchical_wheel'.", name ) );
+}
+
+// hierarchical_wheel_t::init ===============================================
+
+void hierarchical_wheel_t::init()
+{
+  for ( unsigned level = 0; level < LEVELS; ++level )
+  {
+    auto n_slots = size_t( 1 ) << level_bits( level );
+    slots[ level ].resize( n_slots );
+    occupied[ level ].resize( ( n_slots + 63 ) / 64 );
+  }
+}
+
+// hierarchical_wheel_t::insert =============================================
+
+void hierarchical_wheel_t::insert( event_t* e )
+{
+  auto t = static_cast<uint64_t>( e->time.total_millis() );
+  assert( t >= now && "Event scheduled before current wheel time" );
+
+  // Lowest level whose window contains both the event and the wheel time
+  uint64_t diff = t ^ now;
+  for ( unsigned level = 0; level < LEVELS; ++level )
+  {
+    if ( ( diff >> ( level_shift( level ) + level_bits( level ) ) ) == 0 )
+    {
+      append( level, static_cast<unsigned>( ( t >> level_shift( level ) ) & level_mask( level ) ), e );
+      return;
+    }
+  }
+
+  assert( false && "Event beyond hierarchical wheel horizon" );
+}
+
+// hierarchical_wheel_t::pop ================================================
+
+event_t* hierarchical_wheel_t::pop()
+{
+  while ( true )
+  {
+    int s = find_next( 0, static_cast<unsigned>( now & level_mask( 0 ) ) );
+    if ( s >= 0 )
+    {
+      now = ( now & ~level_mask( 0 ) ) | static_cast<uint64_t>( s );
+
+      slot_t& slot = slots[ 0 ][ s ];
+      event_t* e   = slot.head;
+      slot.head    = e->next;
+      if ( !slot.head )
+      {
+        slot.tail = nullptr;
+        occupied[ 0 ][ s / 64 ] &= ~( uint64_t( 1 ) << ( s % 64 ) );
+      }
+
+      return e;
+    }
+
+    // The level 0 window is exhausted, find the next occupied slot above it.
+    // The slot holding the current wheel time is always empty on levels > 0.
+    unsigned level = 1;
+    for ( ; level < LEVELS; ++level )
+    {
+      auto idx = static_cast<unsigned>( ( now >> level_shift( level ) ) & level_mask( level ) );
+      s        = find_next( level, idx + 1 );
+      if ( s >= 0 )
+        break;
+    }
+
+    assert( level < LEVELS && "Hierarchical wheel ran out of events" );
+
+    // Advance to the start of the slot, and cascade it (and subsequently the
+    // first slot of each level below it) down the wheel.
+    unsigned upper = level_shift( level ) + level_bits( level );
+    now = ( ( now >> upper ) << upper ) | ( static_cast<uint64_t>( s ) << level_shift( level ) );
+    for ( ; level > 0; --level )
+    {
+      cascade( level, static_cast<unsigned>( ( now >> level_shift( level ) ) & level_mask( level ) ) );
+    }
+  }
+}
+
+// hierarchical_wheel_t::clear ==============================================
+
+void hierarchical_wheel_t::clear()
+{
+  for ( unsigned level = 0; level < LEVELS; ++level )
+  {
+    slots[ level ].assign( slots[ level ].size(), slot_t() );
+    occupied[ level ].assign( occupied[ level ].size(), 0 );
+  }
+}
+
+// hierarchical_wheel_t::append =============================================
+
+void hierarchical_wheel_t::append( unsigned level, unsigned slot_idx, event_t* e )
+{
+  slot_t& slot = slots[ level ][ slot_idx ];
+  e->next      = nullptr;
+  if ( slot.tail )
+  {
+    slot.tail->next = e;
+  }
+  else
+  {
+    slot.head = e;
+    occupied[ level ][ slot_idx / 64 ] |= uint64_t( 1 ) << ( slot_idx % 64 );
+  }
+  slot.tail = e;
+}
+
+// hierarchical_wheel_t::cascade ============================================
+
+void hierarchical_wheel_t::cascade( unsigned level, unsigned slot_idx )
+{
+  slot_t& slot = slots[ level ][ slot_idx ];
+  event_t* e   = slot.head;
+  if ( !e )
+    return;
+
+  slot = slot_t();
+  occupied[ level ][ slot_idx / 64 ] &= ~( uint64_t( 1 ) << ( slot_idx % 64 ) );
+
+  // Re-inserting in list order keeps same-timestamp events in FIFO order
+  while ( e )
+  {
+    event_t* next = e->next;
+    insert( e );
+    e = next;
+  }
+}
+
+// hierarchical_wheel_t::find_next ==========================================
+
+int hierarchical_wheel_t::find_next( unsigned level, unsigned from ) const
+{
+  const auto& bits = occupied[ level ];
+  auto word        = from / 64;
+  if ( word >= bits.size() )
+    return -1;
+
+  uint64_t v = bits[ word ] & ( ~uint64_t( 0 ) << ( from % 64 ) );
+  while ( true )
+  {
+    if ( v )
+      return static_cast<int>( word * 64 + lowest_set_bit( v ) );
+
+    if ( ++word == bits.size() )
+      return -1;
+
+    v = bits[ word ];
+  }
+}
+
 
 event_manager_t::event_manager_t( sim_t* s )
   : sim( s ),
@@ -20,13 +236,17 @@ event_manager_t::event_manager_t( sim_t* s )
     global_event_id( 1 ),  // start at 1, so we can identify event -> id == 0
                            // meaning a unscheduled event.
     timing_wheel(),
-    recycled_event_list( nullptr ),
+    size_classes(),
+    event_pages(),
+    allocation_size_class( 0 ),
     wheel_seconds( 0 ),
     wheel_size( 0 ),
     wheel_mask( 0 ),
     wheel_shift( 5 ),
     wheel_granularity( 0.0 ),
     wheel_time( timespan_t::zero() ),
+    queue_type( event_queue_e::TIMING_WHEEL ),
+    hierarchical_wheel(),
     event_stopwatch(),
 #ifdef EVENT_QUEUE_DEBUG
     monitor_cpu( false ),
@@ -46,24 +266,24 @@ event_manager_t::event_manager_t( sim_t* s )
 
 // event_manager_t::~event_manager_t ========================================
 
-event_manager_t::~event_manager_t()
-{
-  while ( recycled_event_list )
-  {
-    event_t* e          = recycled_event_list;
-    recycled_event_list = e->next;
-    free( e );
-  }
-}
+// Event memory is owned by the event pages, and released with them.
+event_manager_t::~event_manager_t() = default;
 
 // event_manager_t::allocate_event ==========================================
 
-void* event_manager_t::allocate_event( [[maybe_unused]] const std::size_t size )
+void* event_manager_t::allocate_event( const std::size_t size )
 {
-  static constexpr std::size_t SIZE = util::next_power_of_two( 2 * sizeof( event_t ) );
-  assert( size <= SIZE );
+  unsigned size_class_idx = event_size_class( size );
+  assert( size <= event_size_class_size( size_class_idx ) );
+
+  auto& size_class = size_classes[ size_class_idx ];
+  size_class.requested++;
+
+  // Picked up by the event_t constructor, so the event can be recycled into
+  // the correct free list
+  allocation_size_class = static_cast<uint8_t>( size_class_idx );
 
-  event_t* e = recycled_event_list;
+  event_t* e = size_class.free_list;
 #ifdef EVENT_QUEUE_DEBUG
   n_requested_events++;
   if ( size >= event_requested_size_count.size() )
@@ -74,23 +294,19 @@ void* event_manager_t::allocate_event( [[maybe_unused]] const std::size_t size )
 #endif
   if ( e )
   {
-    recycled_event_list = e->next;
+    size_class.free_list = e->next;
   }
   else
   {
-    e = (event_t*)malloc( SIZE );
+    auto block_size = event_size_class_size( size_class_idx );
+    e = static_cast<event_t*>( event_pages[ size_class_idx ].allocate<std::max_align_t>(
+        block_size / sizeof( std::max_align_t ) ) );
 
-    if ( !e )
-    {
-      throw std::bad_alloc();
-    }
-    else
-    {
 #ifdef EVENT_QUEUE_DEBUG
-      n_allocated_events++;
+    n_allocated_events++;
 #endif
-      allocated_events.push_back( e );
-    }
+    size_class.allocated++;
+    allocated_events.push_back( e );
   }
 
   return e;
@@ -100,10 +316,12 @@ void* event_manager_t::allocate_event( [[maybe_unused]] const std::size_t size )
 
 void event_manager_t::recycle_event( event_t* e )
 {
+  auto& size_class = size_classes[ e->size_class ];
+
   e->~event_t();
-  e->recycled         = true;
-  e->next             = recycled_event_list;
-  recycled_event_list = e;
+  e->recycled          = true;
+  e->next              = size_class.free_list;
+  size_class.free_list = e;
 }
 
 // event_manager_t::add_event ===============================================
@@ -116,6 +334,35 @@ void event_manager_t::add_event( event_t* e, timespan_t delta_time )
   if ( delta_time < timespan_t::zero() )
     delta_time = timespan_t::zero();
 
+  if ( queue_type == event_queue_e::HIERARCHICAL_WHEEL )
+  {
+    insert_hierarchical_wheel( e, delta_time );
+  }
+  else
+  {
+    insert_timing_wheel( e, delta_time );
+  }
+
+  if ( ++events_remaining > max_events_remaining )
+    max_events_remaining = events_remaining;
+
+  if ( sim->debug )
+    sim->print_debug( "Add Event: {} time={} reschedule={}", *e, e->time, e->reschedule_time );
+
+#ifdef ACTOR_EVENT_BOOKKEEPING
+  if ( sim->debug && e->actor )
+  {
+    e->actor->event_counter++;
+    sim->print_debug( "Actor {} has {} scheduled events", e->actor->name(),
+                           e->actor->event_counter );
+  }
+#endif
+}
+
+// event_manager_t::insert_timing_wheel =====================================
+
+void event_manager_t::insert_timing_wheel( event_t* e, timespan_t delta_time )
+{
   if ( delta_time > wheel_time )
   {
     e->time = current_time + wheel_time - timespan_t::from_seconds( 1 );
@@ -170,21 +417,38 @@ void event_manager_t::add_event( event_t* e, timespan_t delta_time )
   // insert event
   e->next = *prev;
   *prev   = e;
+}
 
-  if ( ++events_remaining > max_events_remaining )
-    max_events_remaining = events_remaining;
+// event_manager_t::insert_hierarchical_wheel ===============================
 
-  if ( sim->debug )
-    sim->print_debug( "Add Event: {} time={} reschedule={}", *e, e->time, e->reschedule_time );
+void event_manager_t::insert_hierarchical_wheel( event_t* e, timespan_t delta_time )
+{
+  // Events beyond the span of the wheel are parked at its far end, and
+  // rescheduled from there in the same manner as delayed events.
+  timespan_t last = hierarchical_wheel.horizon() - timespan_t::from_millis( 1 );
+  if ( current_time + delta_time > last )
+  {
+    e->time            = last;
+    e->reschedule_time = current_time + delta_time;
+  }
+  else
+  {
+    e->time            = current_time + delta_time;
+    e->reschedule_time = timespan_t::zero();
+  }
 
-#ifdef ACTOR_EVENT_BOOKKEEPING
-  if ( sim->debug && e->actor )
+#ifdef EVENT_QUEUE_DEBUG
+  // Insertion never traverses, always record it as a tail insert at depth 0
+  events_added++;
+  if ( event_queue_depth_samples.empty() )
   {
-    e->actor->event_counter++;
-    sim->print_debug( "Actor {} has {} scheduled events", e->actor->name(),
-                           e->actor->event_counter );
+    event_queue_depth_samples.resize( 1 );
   }
+  event_queue_depth_samples[ 0 ].first++;
+  event_queue_depth_samples[ 0 ].second++;
 #endif
+
+  hierarchical_wheel.insert( e );
 }
 
 // event_manager_t::reschedule_event ========================================
@@ -313,6 +577,7 @@ void event_manager_t::flush()
 
   // Clear Timing Wheel
   timing_wheel.assign( timing_wheel.size(), nullptr );
+  hierarchical_wheel.clear();
 }
 
 // event_manager_t::init ====================================================
@@ -343,7 +608,14 @@ void event_manager_t::init()
 
   // The timing wheel represents an array of event lists: Each time slice has an
   // event list.
-  timing_wheel.resize( wheel_size );
+  if ( queue_type == event_queue_e::HIERARCHICAL_WHEEL )
+  {
+    hierarchical_wheel.init();
+  }
+  else
+  {
+    timing_wheel.resize( wheel_size );
+  }
 }
 
 // event_manager_t::next_event ==============================================
@@ -353,6 +625,13 @@ event_t* event_manager_t::next_event()
   if ( events_remaining == 0 )
     return nullptr;
 
+  if ( queue_type == event_queue_e::HIERARCHICAL_WHEEL )
+  {
+    events_remaining--;
+    events_processed++;
+    return hierarchical_wheel.pop();
+  }
+
   while ( true )
   {
     event_t*& event_list = timing_wheel[ timing_slice ];
@@ -384,6 +663,7 @@ void event_manager_t::reset()
   events_processed = 0;
   timing_slice     = 0;
   global_event_id  = 0;
+  hierarchical_wheel.reset();
   canceled         = false;
   current_time     = timespan_t::zero();
 }
@@ -395,6 +675,11 @@ void event_manager_t::merge( event_manager_t& other )
   max_events_remaining =
       std::max( max_events_remaining, other.max_events_remaining );
   total_events_processed += other.total_events_processed;
+  for ( size_t i = 0; i < size_classes.size(); ++i )
+  {
+    size_classes[ i ].requested += other.size_classes[ i ].requested;
+    size_classes[ i ].allocated += other.size_classes[ i ].allocated;
+  }
 #ifdef EVENT_QUEUE_DEBUG
   events_traversed += other.events_traversed;
   events_added += other.events_added;
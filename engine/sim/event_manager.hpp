@@ -7,19 +7,90 @@
 
 #include "config.hpp"
 
+#include "event.hpp"
+#include "util/allocator.hpp"
 #include "util/chrono.hpp"
+#include "util/string_view.hpp"
 #include "util/stopwatch.hpp"
 #include "util/timespan.hpp"
 
+#include <array>
 #include <cstdint>
 #include <vector>
 
 struct event_t;
 struct sim_t;
 
+enum class event_queue_e
+{
+  TIMING_WHEEL,       // Single-level wheel of time-sorted slice lists
+  HIERARCHICAL_WHEEL  // Multi-level millisecond wheel with O(1) insert and pop
+};
+
+const char* event_queue_type_string( event_queue_e );
+event_queue_e parse_event_queue_type( util::string_view );
+
+// Hierarchical timing wheel ================================================
+//
+// Level 0 holds one FIFO list per millisecond of the current ~1 second window,
+// each higher level covers 64 slots of the level below it. An event is placed
+// on the lowest level whose window contains both the event time and the
+// current wheel time, and is cascaded down a level each time the wheel enters
+// its slot. Lists are always appended to, so events with the same timestamp
+// are popped in insertion order. Occupancy bitmaps make skipping empty slots
+// cheap.
+struct hierarchical_wheel_t
+{
+  static constexpr unsigned LEVELS      = 4;
+  static constexpr unsigned LEVEL0_BITS = 10;
+  static constexpr unsigned LEVEL_BITS  = 6;
+  static constexpr unsigned TOTAL_BITS  = LEVEL0_BITS + ( LEVELS - 1 ) * LEVEL_BITS;
+
+  struct slot_t
+  {
+    event_t* head = nullptr;
+    event_t* tail = nullptr;
+  };
+
+  std::array<std::vector<slot_t>, LEVELS> slots;
+  std::array<std::vector<uint64_t>, LEVELS> occupied;
+  uint64_t now;
+
+  hierarchical_wheel_t() : now( 0 )
+  { }
+
+  /// First point in time (exclusive) that can be placed on the wheel
+  timespan_t horizon() const
+  { return timespan_t::from_millis( ( ( now >> TOTAL_BITS ) + 1 ) << TOTAL_BITS ); }
+
+  void init();
+  void insert( event_t* );
+  event_t* pop();
+  void clear();
+  void reset()
+  { now = 0; }
+
+private:
+  void append( unsigned level, unsigned slot, event_t* );
+  void cascade( unsigned level, unsigned slot );
+  int find_next( unsigned level, unsigned from ) const;
+};
+
 // Event manager
 struct event_manager_t
 {
+  // Events of each size class are carved from contiguous pages owned by the
+  // event manager (and thus the sim thread), and recycled through a per-class
+  // free list.
+  static constexpr std::size_t EVENT_PAGE_SIZE = 32768;
+
+  struct size_class_t
+  {
+    event_t* free_list = nullptr;
+    uint64_t requested = 0;
+    unsigned allocated = 0;
+  };
+
   sim_t* sim;
   timespan_t current_time;
   uint64_t events_remaining;
@@ -28,11 +99,15 @@ struct event_manager_t
   uint64_t max_events_remaining;
   unsigned timing_slice, global_event_id;
   std::vector<event_t*> timing_wheel;
-  event_t* recycled_event_list;
+  std::array<size_class_t, EVENT_SIZE_CLASSES> size_classes;
+  std::array<util::bump_ptr_allocator_t<EVENT_PAGE_SIZE>, EVENT_SIZE_CLASSES> event_pages;
+  uint8_t allocation_size_class;
   int wheel_seconds, wheel_size, wheel_mask, wheel_shift;
   double wheel_granularity;
   timespan_t wheel_time;
   std::vector<event_t*> allocated_events;
+  event_queue_e queue_type;
+  hierarchical_wheel_t hierarchical_wheel;
 
   stopwatch_t<chrono::thread_clock> event_stopwatch;
   bool monitor_cpu;
@@ -58,4 +133,8 @@ struct event_manager_t
   void reset();
   void merge( event_manager_t& other );
   void cancel_stuck( std::vector<std::string>& debug_list );
+
+private:
+  void insert_timing_wheel( event_t*, timespan_t delta_time );
+  void insert_hierarchical_wheel( event_t*, timespan_t delta_time );
 };
@@ -8,6 +8,8 @@
 #include "player/player.hpp"
 #include "sim/sim.hpp"
 #include <atomic>
+#include <limits>
+#include <typeinfo>
 
 namespace expression
 {
@@ -144,18 +146,32 @@ struct lexer_t
 
 // Unary Operators ==========================================================
 
-template <class F>
-class expr_unary_t : public expr_t
+class unary_base_t : public expr_t
 {
+public:
   std::unique_ptr<expr_t> input;
 
-public:
-  expr_unary_t( util::string_view n, token_e o, std::unique_ptr<expr_t> i )
+  unary_base_t( util::string_view n, token_e o, std::unique_ptr<expr_t> i )
     : expr_t( n, o ), input( std::move(i) )
   {
     assert(input);
   }
 
+  unsigned dependencies() const override
+  {
+    return input->dependencies();
+  }
+};
+
+template <class F>
+class expr_unary_t : public unary_base_t
+{
+public:
+  expr_unary_t( util::string_view n, token_e o, std::unique_ptr<expr_t> i )
+    : unary_base_t( n, o, std::move(i) )
+  {
+  }
+
   double evaluate() override  // override
   {
     return F()( input->eval() );
@@ -254,6 +270,11 @@ public:
     assert(left);
     assert(right);
   }
+
+  unsigned dependencies() const override
+  {
+    return left->dependencies() | right->dependencies();
+  }
 };
 
 class logical_and_t : public binary_base_t
@@ -367,15 +388,12 @@ std::unique_ptr<expr_t> select_binary( bool analyze, util::string_view name, tok
 // Analyzing Unary Operators ================================================
 
 template <class F>
-class expr_analyze_unary_t : public expr_t
+class expr_analyze_unary_t : public unary_base_t
 {
-  std::unique_ptr<expr_t> input;
-
 public:
   expr_analyze_unary_t( util::string_view n, token_e o, std::unique_ptr<expr_t> i )
-    : expr_t( n, o ), input( std::move(i) )
+    : unary_base_t( n, o, std::move(i) )
   {
-    assert( input );
   }
 
   double evaluate() override  // override
@@ -493,23 +511,65 @@ public:
   }
 };
 
+// Operator token of a binary function object, for compiling reduced expressions
+template <template <typename> class F>
+struct binary_token;
+template <> struct binary_token<std::logical_and> { static constexpr token_e value = TOK_AND; };
+template <> struct binary_token<std::logical_or> { static constexpr token_e value = TOK_OR; };
+template <> struct binary_token<std::plus> { static constexpr token_e value = TOK_ADD; };
+template <> struct binary_token<std::minus> { static constexpr token_e value = TOK_SUB; };
+template <> struct binary_token<std::multiplies> { static constexpr token_e value = TOK_MULT; };
+template <> struct binary_token<std::divides> { static constexpr token_e value = TOK_DIV; };
+template <> struct binary_token<binary::modulus> { static constexpr token_e value = TOK_MOD; };
+template <> struct binary_token<binary::max> { static constexpr token_e value = TOK_MAX; };
+template <> struct binary_token<binary::min> { static constexpr token_e value = TOK_MIN; };
+template <> struct binary_token<std::equal_to> { static constexpr token_e value = TOK_EQ; };
+template <> struct binary_token<std::not_equal_to> { static constexpr token_e value = TOK_NOTEQ; };
+template <> struct binary_token<std::less> { static constexpr token_e value = TOK_LT; };
+template <> struct binary_token<std::less_equal> { static constexpr token_e value = TOK_LTEQ; };
+template <> struct binary_token<std::greater> { static constexpr token_e value = TOK_GT; };
+template <> struct binary_token<std::greater_equal> { static constexpr token_e value = TOK_GTEQ; };
+
+// Binary operation with one operand reduced to a constant
+struct reduced_base_t : public expr_t
+{
+  token_e fn;
+  double constant;
+  std::unique_ptr<expr_t> operand;
+
+  reduced_base_t( util::string_view n, token_e o, token_e f, double c, std::unique_ptr<expr_t> e )
+    : expr_t( n, o ), fn( f ), constant( c ), operand( std::move( e ) )
+  {
+  }
+
+  virtual bool constant_left() const = 0;
+
+  unsigned dependencies() const override
+  {
+    return operand->dependencies();
+  }
+};
+
 template <template <typename> class F, typename T = double>
-struct left_reduced_t : public expr_t
+struct left_reduced_t : public reduced_base_t
 {
-  double left;
-  std::unique_ptr<expr_t> right;
   left_reduced_t( util::string_view n, token_e o, double l, std::unique_ptr<expr_t> r )
-    : expr_t( n, o ), left( l ), right( std::move(r) )
+    : reduced_base_t( n, o, binary_token<F>::value, l, std::move(r) )
   {
   }
-  
+
+  bool constant_left() const override
+  {
+    return true;
+  }
+
   std::unique_ptr<expr_t> build_optimized_expression( bool analyze_further, int spacing ) override
   {
-    expr_t::optimize_expression( right, analyze_further, spacing + 2 );
-    bool right_constant = right->is_constant();
+    expr_t::optimize_expression( operand, analyze_further, spacing + 2 );
+    bool right_constant = operand->is_constant();
     if ( right_constant )
     {
-      auto result = static_cast<double>( F<T>()( static_cast<T>( left ), static_cast<T>( right->evaluate() ) ) );
+      auto result = static_cast<double>( F<T>()( static_cast<T>( constant ), static_cast<T>( operand->evaluate() ) ) );
       if ( EXPRESSION_DEBUG )
       {
         printf( "Reduced %*d %s binary expression to %f\n", spacing, id(), name(), result );
@@ -521,27 +581,30 @@ struct left_reduced_t : public expr_t
 
   double evaluate() override
   {
-    return static_cast<double>( F<T>()( static_cast<T>( left ), static_cast<T>( right->eval() ) ) );
+    return static_cast<double>( F<T>()( static_cast<T>( constant ), static_cast<T>( operand->eval() ) ) );
   }
 };
 
 template <template <typename> class F, typename T = double>
-struct right_reduced_t : public expr_t
+struct right_reduced_t : public reduced_base_t
 {
-  std::unique_ptr<expr_t> left;
-  double right;
   right_reduced_t( util::string_view n, token_e o, std::unique_ptr<expr_t> l, double r )
-    : expr_t( n, o ), left( std::move(l) ), right( r )
+    : reduced_base_t( n, o, binary_token<F>::value, r, std::move(l) )
   {
   }
 
+  bool constant_left() const override
+  {
+    return false;
+  }
+
   std::unique_ptr<expr_t> build_optimized_expression( bool analyze_further, int spacing ) override
   {
-    expr_t::optimize_expression( left, analyze_further, spacing + 2 );
-    bool left_constant = left->is_constant();
+    expr_t::optimize_expression( operand, analyze_further, spacing + 2 );
+    bool left_constant = operand->is_constant();
     if ( left_constant )
     {
-      auto result = static_cast<double>( F<T>()( static_cast<T>( left->evaluate() ), static_cast<T>( right ) ) );
+      auto result = static_cast<double>( F<T>()( static_cast<T>( operand->evaluate() ), static_cast<T>( constant ) ) );
       if ( EXPRESSION_DEBUG )
       {
         printf( "Reduced %*d %s binary expression to %f\n", spacing, id(), name(), result );
@@ -553,7 +616,7 @@ struct right_reduced_t : public expr_t
 
   double evaluate() override
   {
-    return static_cast<double>( F<T>()( static_cast<T>( left->eval() ), static_cast<T>( right ) ) );
+    return static_cast<double>( F<T>()( static_cast<T>( operand->eval() ), static_cast<T>( constant ) ) );
   }
 };
 class analyze_logical_and_t : public analyze_binary_base_t
@@ -1030,6 +1093,357 @@ int precedence( token_e expr_token_type )
   }
 }
 
+// Compiled Expressions =====================================================
+
+// Optimized expression tree flattened into a linear program over a register file. Each tree node
+// writes to its own register, operators and directly readable leaves are executed in a single loop
+// over the instructions, and all other nodes are called through the original tree, which the
+// program keeps ownership of. Logical and/or retain short circuiting through forward jumps.
+class program_expr_t : public expr_t
+{
+public:
+  enum opcode_e : uint8_t
+  {
+    OP_CONST,
+    OP_CALL,
+    OP_LOAD_DOUBLE,
+    OP_LOAD_INT,
+    OP_LOAD_UNSIGNED,
+    OP_LOAD_BOOL,
+    OP_LOAD_TIMESPAN,
+    OP_LOAD_STACK_UP,
+    OP_LOAD_STACK_DOWN,
+    OP_LOAD_REMAINS,
+    OP_LOAD_PASSED,
+    OP_NEG,
+    OP_NOT,
+    OP_ABS,
+    OP_FLOOR,
+    OP_CEIL,
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_MOD,
+    OP_MAX,
+    OP_MIN,
+    OP_EQ,
+    OP_NOTEQ,
+    OP_LT,
+    OP_LTEQ,
+    OP_GT,
+    OP_GTEQ,
+    OP_XOR,
+    OP_LAND,     // a && b, both operands evaluated
+    OP_LOR,      // a || b, both operands evaluated
+    OP_AND_LEFT, // if !a: dst = 0, jump to b
+    OP_OR_LEFT,  // if a: dst = 1, jump to b
+    OP_BOOL,     // dst = a != 0
+  };
+
+  struct instruction_t
+  {
+    opcode_e op;
+    uint16_t dst;
+    uint16_t a;
+    uint16_t b;
+    union
+    {
+      double value;
+      expr_t* expr;
+      const void* address;
+    };
+    const timespan_t* now;
+  };
+
+private:
+  std::unique_ptr<expr_t> tree;
+  std::vector<instruction_t> instructions;
+  std::vector<double> registers;
+  uint16_t result;
+  size_t n_operators;
+  bool overflow;
+
+  uint16_t allocate()
+  {
+    if ( registers.size() >= std::numeric_limits<uint16_t>::max() )
+    {
+      overflow = true;
+      return 0;
+    }
+    registers.push_back( 0 );
+    return static_cast<uint16_t>( registers.size() - 1 );
+  }
+
+  instruction_t& emit( opcode_e op, uint16_t dst, uint16_t a = 0, uint16_t b = 0 )
+  {
+    if ( instructions.size() >= std::numeric_limits<uint16_t>::max() )
+    {
+      overflow = true;
+    }
+    instruction_t i {};
+    i.op  = op;
+    i.dst = dst;
+    i.a   = a;
+    i.b   = b;
+    instructions.push_back( i );
+    return instructions.back();
+  }
+
+  static opcode_e binary_opcode( token_e t )
+  {
+    switch ( t )
+    {
+      case TOK_ADD:   return OP_ADD;
+      case TOK_SUB:   return OP_SUB;
+      case TOK_MULT:  return OP_MUL;
+      case TOK_DIV:   return OP_DIV;
+      case TOK_MOD:   return OP_MOD;
+      case TOK_MAX:   return OP_MAX;
+      case TOK_MIN:   return OP_MIN;
+      case TOK_EQ:    return OP_EQ;
+      case TOK_NOTEQ: return OP_NOTEQ;
+      case TOK_LT:    return OP_LT;
+      case TOK_LTEQ:  return OP_LTEQ;
+      case TOK_GT:    return OP_GT;
+      case TOK_GTEQ:  return OP_GTEQ;
+      case TOK_XOR:   return OP_XOR;
+      case TOK_AND:   return OP_LAND;
+      case TOK_OR:    return OP_LOR;
+      default:        return OP_CALL;
+    }
+  }
+
+  static opcode_e unary_opcode( token_e t )
+  {
+    switch ( t )
+    {
+      case TOK_MINUS: return OP_NEG;
+      case TOK_NOT:   return OP_NOT;
+      case TOK_ABS:   return OP_ABS;
+      case TOK_FLOOR: return OP_FLOOR;
+      case TOK_CEIL:  return OP_CEIL;
+      default:        return OP_CALL;
+    }
+  }
+
+  static opcode_e load_opcode( load_t::kind_e k )
+  {
+    switch ( k )
+    {
+      case load_t::DOUBLE:     return OP_LOAD_DOUBLE;
+      case load_t::INT:        return OP_LOAD_INT;
+      case load_t::UNSIGNED:   return OP_LOAD_UNSIGNED;
+      case load_t::BOOL:       return OP_LOAD_BOOL;
+      case load_t::TIMESPAN:   return OP_LOAD_TIMESPAN;
+      case load_t::STACK_UP:   return OP_LOAD_STACK_UP;
+      case load_t::STACK_DOWN: return OP_LOAD_STACK_DOWN;
+      case load_t::REMAINS:    return OP_LOAD_REMAINS;
+      case load_t::PASSED:     return OP_LOAD_PASSED;
+      default:                 return OP_CALL;
+    }
+  }
+
+  uint16_t call( expr_t* node )
+  {
+    auto dst = allocate();
+    emit( OP_CALL, dst ).expr = node;
+    return dst;
+  }
+
+  // Lower a node into instructions, returning the register holding its value. Operands are
+  // lowered left to right, matching the evaluation order of the tree.
+  uint16_t lower( expr_t* node )
+  {
+    if ( overflow )
+    {
+      return 0;
+    }
+
+    if ( node->is_analyze_expression() )
+    {
+      return call( node );
+    }
+
+    if ( auto c = dynamic_cast<const_expr_t*>( node ) )
+    {
+      auto dst = allocate();
+      emit( OP_CONST, dst ).value = c->evaluate();
+      return dst;
+    }
+
+    if ( auto b = dynamic_cast<binary_base_t*>( node ) )
+    {
+      if ( b->op_ == TOK_AND || b->op_ == TOK_OR )
+      {
+        ++n_operators;
+        auto dst  = allocate();
+        auto left = lower( b->left.get() );
+        auto jump = instructions.size();
+        emit( b->op_ == TOK_AND ? OP_AND_LEFT : OP_OR_LEFT, dst, left );
+        auto right = lower( b->right.get() );
+        emit( OP_BOOL, dst, right );
+        instructions[ jump ].b = static_cast<uint16_t>( instructions.size() );
+        return dst;
+      }
+
+      auto op = binary_opcode( b->op_ );
+      if ( op != OP_CALL )
+      {
+        ++n_operators;
+        auto left  = lower( b->left.get() );
+        auto right = lower( b->right.get() );
+        auto dst   = allocate();
+        emit( op, dst, left, right );
+        return dst;
+      }
+
+      return call( node );
+    }
+
+    if ( auto u = dynamic_cast<unary_base_t*>( node ) )
+    {
+      auto op = unary_opcode( u->op_ );
+      if ( op != OP_CALL )
+      {
+        ++n_operators;
+        auto input = lower( u->input.get() );
+        auto dst   = allocate();
+        emit( op, dst, input );
+        return dst;
+      }
+
+      return call( node );
+    }
+
+    if ( auto r = dynamic_cast<reduced_base_t*>( node ) )
+    {
+      auto op = binary_opcode( r->fn );
+      if ( op != OP_CALL )
+      {
+        ++n_operators;
+        auto constant = allocate();
+        emit( OP_CONST, constant ).value = r->constant;
+        auto operand = lower( r->operand.get() );
+        auto dst     = allocate();
+        if ( r->constant_left() )
+          emit( op, dst, constant, operand );
+        else
+          emit( op, dst, operand, constant );
+        return dst;
+      }
+
+      return call( node );
+    }
+
+    load_t l;
+    if ( node->load( l ) )
+    {
+      auto op = load_opcode( l.kind );
+      if ( op != OP_CALL )
+      {
+        auto dst = allocate();
+        auto& i  = emit( op, dst );
+        i.address = l.address;
+        i.now     = l.now;
+        return dst;
+      }
+    }
+
+    return call( node );
+  }
+
+public:
+  program_expr_t( std::unique_ptr<expr_t> t )
+    : expr_t( t->name() ), tree( std::move( t ) ), result( 0 ), n_operators( 0 ), overflow( false )
+  {
+    result = lower( tree.get() );
+  }
+
+  // Program is worth running in place of the tree
+  bool valid() const
+  {
+    return !overflow && n_operators > 0;
+  }
+
+  std::unique_ptr<expr_t> release()
+  {
+    return std::move( tree );
+  }
+
+  unsigned dependencies() const override
+  {
+    return tree->dependencies();
+  }
+
+  double evaluate() override
+  {
+    double* r                 = registers.data();
+    const instruction_t* code = instructions.data();
+    size_t n                  = instructions.size();
+    size_t pc                 = 0;
+
+    while ( pc < n )
+    {
+      const instruction_t& i = code[ pc++ ];
+      switch ( i.op )
+      {
+        case OP_CONST:           r[ i.dst ] = i.value; break;
+        case OP_CALL:            r[ i.dst ] = i.expr->eval(); break;
+        case OP_LOAD_DOUBLE:     r[ i.dst ] = *static_cast<const double*>( i.address ); break;
+        case OP_LOAD_INT:        r[ i.dst ] = *static_cast<const int*>( i.address ); break;
+        case OP_LOAD_UNSIGNED:   r[ i.dst ] = *static_cast<const unsigned*>( i.address ); break;
+        case OP_LOAD_BOOL:       r[ i.dst ] = *static_cast<const bool*>( i.address ); break;
+        case OP_LOAD_TIMESPAN:   r[ i.dst ] = static_cast<const timespan_t*>( i.address )->total_seconds(); break;
+        case OP_LOAD_STACK_UP:   r[ i.dst ] = *static_cast<const int*>( i.address ) > 0; break;
+        case OP_LOAD_STACK_DOWN: r[ i.dst ] = *static_cast<const int*>( i.address ) <= 0; break;
+        case OP_LOAD_REMAINS:
+          r[ i.dst ] = std::max( timespan_t::zero(), *static_cast<const timespan_t*>( i.address ) - *i.now ).total_seconds();
+          break;
+        case OP_LOAD_PASSED:     r[ i.dst ] = *static_cast<const timespan_t*>( i.address ) <= *i.now; break;
+        case OP_NEG:             r[ i.dst ] = -r[ i.a ]; break;
+        case OP_NOT:             r[ i.dst ] = !r[ i.a ]; break;
+        case OP_ABS:             r[ i.dst ] = std::fabs( r[ i.a ] ); break;
+        case OP_FLOOR:           r[ i.dst ] = std::floor( r[ i.a ] ); break;
+        case OP_CEIL:            r[ i.dst ] = std::ceil( r[ i.a ] ); break;
+        case OP_ADD:             r[ i.dst ] = r[ i.a ] + r[ i.b ]; break;
+        case OP_SUB:             r[ i.dst ] = r[ i.a ] - r[ i.b ]; break;
+        case OP_MUL:             r[ i.dst ] = r[ i.a ] * r[ i.b ]; break;
+        case OP_DIV:             r[ i.dst ] = r[ i.a ] / r[ i.b ]; break;
+        case OP_MOD:             r[ i.dst ] = std::fmod( r[ i.a ], r[ i.b ] ); break;
+        case OP_MAX:             r[ i.dst ] = std::max( r[ i.a ], r[ i.b ] ); break;
+        case OP_MIN:             r[ i.dst ] = std::min( r[ i.a ], r[ i.b ] ); break;
+        case OP_EQ:              r[ i.dst ] = r[ i.a ] == r[ i.b ]; break;
+        case OP_NOTEQ:           r[ i.dst ] = r[ i.a ] != r[ i.b ]; break;
+        case OP_LT:              r[ i.dst ] = r[ i.a ] < r[ i.b ]; break;
+        case OP_LTEQ:            r[ i.dst ] = r[ i.a ] <= r[ i.b ]; break;
+        case OP_GT:              r[ i.dst ] = r[ i.a ] > r[ i.b ]; break;
+        case OP_GTEQ:            r[ i.dst ] = r[ i.a ] >= r[ i.b ]; break;
+        case OP_XOR:             r[ i.dst ] = ( r[ i.a ] != 0 ) != ( r[ i.b ] != 0 ); break;
+        case OP_LAND:            r[ i.dst ] = r[ i.a ] && r[ i.b ]; break;
+        case OP_LOR:             r[ i.dst ] = r[ i.a ] || r[ i.b ]; break;
+        case OP_AND_LEFT:
+          if ( r[ i.a ] == 0 )
+          {
+            r[ i.dst ] = 0;
+            pc         = i.b;
+          }
+          break;
+        case OP_OR_LEFT:
+          if ( r[ i.a ] != 0 )
+          {
+            r[ i.dst ] = 1;
+            pc         = i.b;
+          }
+          break;
+        case OP_BOOL:            r[ i.dst ] = r[ i.a ] != 0; break;
+      }
+    }
+
+    return r[ result ];
+  }
+};
+
 }  // UNNAMED NAMESPACE ====================================================
 
 // is_unary =================================================================
@@ -1281,6 +1695,129 @@ std::unique_ptr<expr_t> build_player_expression_tree(
   return res;
 }
 
+// compile ==================================================================
+
+void compile( std::unique_ptr<expr_t>& expression )
+{
+  if ( !expression || expression->is_constant() || dynamic_cast<program_expr_t*>( expression.get() ) )
+  {
+    return;
+  }
+
+  auto program = std::make_unique<program_expr_t>( std::move( expression ) );
+  if ( program->valid() )
+  {
+    expression = std::move( program );
+  }
+  else
+  {
+    expression = program->release();
+  }
+}
+
+namespace
+{
+// Cached value of an expression with known dependencies
+class memo_expr_t : public expr_t
+{
+  std::unique_ptr<expr_t> expr;
+  action_t& action;
+  const sim_t& sim;
+  unsigned mask;
+
+  bool valid;
+  timespan_t time;
+  const player_t* target;
+  uint64_t generation;
+  double value;
+
+  // Generation counters only increase, so their sum changes whenever any of them does
+  uint64_t current_generation() const
+  {
+    uint64_t g = 0;
+    for ( unsigned i = 0; i < static_cast<unsigned>( state_generation::MAX ); ++i )
+    {
+      if ( mask & ( 1U << i ) )
+        g += sim.state_generations[ i ];
+    }
+    return g;
+  }
+
+public:
+  memo_expr_t( std::unique_ptr<expr_t> e, action_t& a )
+    : expr_t( e->name() ), expr( std::move( e ) ), action( a ), sim( *a.sim ), mask( expr->dependencies() ),
+      valid( false ), time( timespan_t::zero() ), target( nullptr ), generation( 0 ), value( 0 )
+  { }
+
+  void invalidate()
+  {
+    valid = false;
+  }
+
+  double evaluate() override
+  {
+    timespan_t now = sim.current_time();
+    const player_t* t = action.get_expression_target();
+    uint64_t g = current_generation();
+
+    if ( valid && now == time && t == target && g == generation )
+    {
+      return value;
+    }
+
+    value      = expr->eval();
+    valid      = true;
+    time       = now;
+    target     = t;
+    generation = g;
+
+    return value;
+  }
+
+  bool is_constant() override
+  {
+    return expr->is_constant();
+  }
+
+  unsigned dependencies() const override
+  {
+    return mask;
+  }
+};
+}  // namespace
+
+void memoize( std::unique_ptr<expr_t>& expression, action_t& action )
+{
+  if ( !expression )
+  {
+    return;
+  }
+
+  if ( auto memo = dynamic_cast<memo_expr_t*>( expression.get() ) )
+  {
+    memo->invalidate();
+    return;
+  }
+
+  // Single leaves are cheaper to evaluate than to look up
+  if ( !dynamic_cast<program_expr_t*>( expression.get() ) && !dynamic_cast<unary_base_t*>( expression.get() ) &&
+       !dynamic_cast<binary_base_t*>( expression.get() ) && !dynamic_cast<reduced_base_t*>( expression.get() ) )
+  {
+    return;
+  }
+
+  auto mask = expression->dependencies();
+  if ( expression->is_constant() || mask == NO_DEPENDENCIES || mask == UNKNOWN_DEPENDENCIES )
+  {
+    return;
+  }
+
+  action.sim->print_debug( "{} memoizing expression '{}' of {}", *action.player, expression->name(),
+                           action.signature_str );
+
+  expression = std::make_unique<memo_expr_t>( std::move( expression ), action );
+}
+
 }  // expression
 
 #if !defined( NDEBUG )
@@ -1368,6 +1905,11 @@ void expr_t::optimize_expression( std::unique_ptr<expr_t>& expression, sim_t& si
   }
   if ( sim.optimize_expressions - 1 - iterations < 0 )
   {
+    // Without optimization, compile the tree as built
+    if ( sim.optimize_expressions == 0 && iterations == 0 && sim.compile_expressions )
+    {
+      expression::compile( expression );
+    }
     return;
   }
   bool analyze_further = sim.optimize_expressions - 1 - iterations  > 0;
@@ -1376,6 +1918,12 @@ void expr_t::optimize_expression( std::unique_ptr<expr_t>& expression, sim_t& si
   {
     optimize_expression( expression, analyze_further );
   }
+
+  // Last optimization pass, the tree is final
+  if ( !analyze_further && sim.compile_expressions )
+  {
+    expression::compile( expression );
+  }
 }
 
 // action_expr_t::create_constant ===========================================
@@ -1483,6 +2031,30 @@ player_t* target_wrapper_expr_t::target() const
   return action.get_expression_target();
 }
 
+bool target_wrapper_expr_t::evaluate_targets( const action_t& a, util::span<player_t* const> expression_targets,
+                                              util::span<double> results )
+{
+  // Derived wrappers may resolve their target differently
+  if ( &a != &action || typeid( *this ) != typeid( target_wrapper_expr_t ) )
+  {
+    return false;
+  }
+
+  for ( size_t i = 0; i < expression_targets.size(); ++i )
+  {
+    player_t* t = expression_targets[ i ];
+    auto& expr  = proxy_expr[ t->actor_index ];
+    if ( expr == nullptr )
+    {
+      expr = t->create_expression( suffix_expr_str );
+    }
+
+    results[ i ] = expr->eval();
+  }
+
+  return true;
+}
+
 #ifdef UNIT_TEST
 
 uint32_t dbc::get_school_mask( school_e )
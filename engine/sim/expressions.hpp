@@ -6,10 +6,12 @@
 #pragma once
 
 #include "config.hpp"
+#include "sc_enums.hpp"
 #include <string>
 #include <vector>
 #include <functional>
 #include <memory>
+#include <type_traits>
 
 #include "util/timespan.hpp"
 #include "util/span.hpp"
@@ -73,6 +75,51 @@ bool convert_to_rpn( std::vector<expr_token_t>& tokens );
 std::unique_ptr<expr_t> build_player_expression_tree(
     player_t& player, std::vector<expression::expr_token_t>& tokens,
     bool optimize );
+
+// Direct read of a leaf value, used by compiled expressions in place of a virtual evaluate() call
+struct load_t
+{
+  enum kind_e
+  {
+    NONE = 0,
+    DOUBLE,     // *address
+    INT,        // *address
+    UNSIGNED,   // *address
+    BOOL,       // *address
+    TIMESPAN,   // *address, in seconds
+    STACK_UP,   // *address > 0
+    STACK_DOWN, // *address <= 0
+    REMAINS,    // max( 0, *address - *now ), in seconds
+    PASSED,     // *address <= *now
+  };
+
+  kind_e kind = NONE;
+  const void* address = nullptr;
+  const timespan_t* now = nullptr;
+};
+
+/* Compile a fully optimized expression tree into a linear register program. Operators and leaves
+ * that can be read directly are evaluated without virtual calls, everything else is called through
+ * the original expression node. Evaluation order and results are unchanged.
+ */
+void compile( std::unique_ptr<expr_t>& expression );
+
+// Dependency mask of an expression, one bit per kind of tracked simulation state. Expressions that
+// read any other state report UNKNOWN_DEPENDENCIES.
+constexpr unsigned NO_DEPENDENCIES      = 0U;
+constexpr unsigned UNKNOWN_DEPENDENCIES = ~0U;
+
+constexpr unsigned depends_on( state_generation s )
+{
+  return 1U << static_cast<unsigned>( s );
+}
+
+/* Cache the value of a final expression tree of action. The cached value is reused while the
+ * current time, the expression target of the action and the generations of all state the
+ * expression depends on stay the same. Expressions with unknown dependencies are left as is.
+ * Memoizing an already memoized expression drops its cached value.
+ */
+void memoize( std::unique_ptr<expr_t>& expression, action_t& action );
 }
 
 /// Action expression
@@ -163,6 +210,30 @@ public:
     return false;
   }
 
+  // Describe how the value of the expression can be read directly, if possible
+  virtual bool load( expression::load_t& /* l */ ) const
+  {
+    return false;
+  }
+
+  /* Simulation state the value of the expression depends on, besides the current time and the
+   * expression target. See expression::depends_on().
+   */
+  virtual unsigned dependencies() const
+  {
+    return expression::UNKNOWN_DEPENDENCIES;
+  }
+
+  /* Evaluate the expression of action a for several targets at once, without switching the target
+   * of the action. expression_targets holds a.get_expression_target() for each candidate target.
+   * Returns false if the expression does not support batch evaluation.
+   */
+  virtual bool evaluate_targets( const action_t& /* a */, util::span<player_t* const> /* expression_targets */,
+                                 util::span<double> /* results */ )
+  {
+    return false;
+  }
+
   expression::token_e op_;
 
 private:
@@ -200,6 +271,11 @@ public:
   {
     return true;
   }
+
+  unsigned dependencies() const override
+  {
+    return expression::NO_DEPENDENCIES;
+  }
 };
 
 // Reference Expression - ref_expr_t
@@ -219,6 +295,25 @@ private:
   {
     return coerce( t );
   }
+
+  bool load( expression::load_t& l ) const override
+  {
+    if constexpr ( std::is_same_v<std::remove_cv_t<T>, double> )
+      l.kind = expression::load_t::DOUBLE;
+    else if constexpr ( std::is_same_v<std::remove_cv_t<T>, int> )
+      l.kind = expression::load_t::INT;
+    else if constexpr ( std::is_same_v<std::remove_cv_t<T>, unsigned> )
+      l.kind = expression::load_t::UNSIGNED;
+    else if constexpr ( std::is_same_v<std::remove_cv_t<T>, bool> )
+      l.kind = expression::load_t::BOOL;
+    else if constexpr ( std::is_same_v<std::remove_cv_t<T>, timespan_t> )
+      l.kind = expression::load_t::TIMESPAN;
+    else
+      return false;
+
+    l.address = &t;
+    return true;
+  }
 };
 
 // Template to return a reference expression
@@ -259,6 +354,8 @@ struct target_wrapper_expr_t : public expr_t
                          util::string_view expr_str );
   virtual player_t* target() const;
   double evaluate() override;
+  bool evaluate_targets( const action_t& a, util::span<player_t* const> expression_targets,
+                         util::span<double> results ) override;
 };
 
 // Template to return a function expression
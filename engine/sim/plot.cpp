@@ -124,99 +124,111 @@ void plot_t::analyze_stats()
       remaining_plot_stats++;
   num_plot_stats = remaining_plot_stats;
 
-  for ( stat_e i = STAT_NONE; i < STAT_MAX; i++ )
+  int start;
+  int end;
+
+  if ( dps_plot_positive )
+  {
+    start = 0;
+    end = dps_plot_points;
+  }
+  else if ( dps_plot_negative )
   {
-    if ( sim->is_canceled() )
-      break;
+    start = -dps_plot_points;
+    end = 0;
+  }
+  else
+  {
+    start = -dps_plot_points / 2;
+    end = -start;
+  }
 
+  // Plot points of all stats, the baseline sim provides the zero point of each stat
+  std::vector<std::pair<stat_e, int>> points;
+  for ( stat_e i = STAT_NONE; i < STAT_MAX; i++ )
+  {
     if ( !is_plot_stat( i ) )
       continue;
 
-    current_plot_stat = i;
+    for ( int j = start; j <= end; j++ )
+    {
+      points.emplace_back( i, j );
+    }
+  }
 
-    remaining_plot_points = dps_plot_points;
+  sim->execute_delta_sims( points.size(), [ this, &points ]( size_t n ) -> sim_t* {
+    stat_e i = points[ n ].first;
+    int j = points[ n ].second;
+
+    current_plot_stat = i;
 
-    int start;
-    int end;
+    if ( j == 0 )
+      return nullptr;
 
-    if ( dps_plot_positive )
+    auto delta_sim = new sim_t( sim );
+    if ( dps_plot_iterations > 0 )
     {
-      start = 0;
-      end = dps_plot_points;
+      delta_sim->work_queue->init( dps_plot_iterations );
     }
-    else if ( dps_plot_negative )
+    if ( dps_plot_target_error > 0 )
+      delta_sim->target_error = dps_plot_target_error;
+    // delta_sim->enchant.add_stat( i, j * dps_plot_step );
+    delta_sim->scaling->scale_stat = i;
+    delta_sim->scaling->scale_value = j * dps_plot_step;
+    delta_sim->progress_bar.set_base( util::to_string( j * dps_plot_step ) + " " + util::stat_type_abbrev( i ) );
+    return delta_sim;
+  }, [ this, &points, start, end ]( size_t n, sim_t* s ) {
+    stat_e i = points[ n ].first;
+    int j = points[ n ].second;
+    std::unique_ptr<sim_t> delta_sim( s );
+
+    if ( j == start )
     {
-      start = -dps_plot_points;
-      end = 0;
+      remaining_plot_points = dps_plot_points;
     }
-    else
+
+    if ( delta_sim && dps_plot_debug )
     {
-      start = -dps_plot_points / 2;
-      end = -start;
+      sim->out_debug.raw().print( "Stat={} Point={}\n", util::stat_type_string( i ), j );
+      report::print_text( delta_sim.get(), true );
     }
 
-    for ( int j = start; j <= end; j++ )
+    for ( player_t* p : sim->players_by_name )
     {
-      if ( sim->is_canceled() )
-        break;
+      if ( !p->scaling->scales_with[ i ] )
+        continue;
 
-      std::unique_ptr<sim_t> delta_sim;
+      plot_data_t data;
 
-      if ( j != 0 )
+      if ( delta_sim )
       {
-        delta_sim = std::make_unique<sim_t>( sim );
-        if ( dps_plot_iterations > 0 )
-        {
-          delta_sim->work_queue->init( dps_plot_iterations );
-        }
-        if ( dps_plot_target_error > 0 )
-          delta_sim->target_error = dps_plot_target_error;
-        // delta_sim->enchant.add_stat( i, j * dps_plot_step );
-        delta_sim->scaling->scale_stat = i;
-        delta_sim->scaling->scale_value = j * dps_plot_step;
-        delta_sim->progress_bar.set_base( util::to_string( j * dps_plot_step ) + " " + util::stat_type_abbrev( i ) );
-        delta_sim->execute();
-        if ( dps_plot_debug )
-        {
-          sim->out_debug.raw().print( "Stat={} Point={}\n", util::stat_type_string( i ), j );
-          report::print_text( delta_sim.get(), true );
-        }
-      }
+        player_t* delta_p = delta_sim->find_player( p->name() );
 
-      for ( player_t* p : sim->players_by_name )
-      {
-        if ( !p->scaling->scales_with[ i ] )
-          continue;
-
-        plot_data_t data;
-
-        if ( delta_sim )
-        {
-          player_t* delta_p = delta_sim->find_player( p->name() );
-
-          scaling_metric_data_t scaling_data = delta_p->scaling_for_metric( p->sim->scaling->scaling_metric );
-
-          data.value = scaling_data.value;
-          data.error = scaling_data.stddev * delta_sim->confidence_estimator;
-        }
-        else
-        {
-          scaling_metric_data_t scaling_data = p->scaling_for_metric( p->sim->scaling->scaling_metric );
-          data.value = scaling_data.value;
-          data.error = scaling_data.stddev * sim->confidence_estimator;
-        }
-        data.plot_step = j * dps_plot_step;
-        p->dps_plot_data[ i ].push_back( data );
-      }
+        scaling_metric_data_t scaling_data = delta_p->scaling_for_metric( p->sim->scaling->scaling_metric );
 
-      if ( delta_sim )
+        data.value = scaling_data.value;
+        data.error = scaling_data.stddev * delta_sim->confidence_estimator;
+      }
+      else
       {
-        remaining_plot_points--;
+        scaling_metric_data_t scaling_data = p->scaling_for_metric( p->sim->scaling->scaling_metric );
+        data.value = scaling_data.value;
+        data.error = scaling_data.stddev * sim->confidence_estimator;
       }
+      data.plot_step = j * dps_plot_step;
+      p->dps_plot_data[ i ].push_back( data );
     }
 
-    remaining_plot_stats--;
-  }
+    if ( delta_sim )
+    {
+      remaining_plot_points--;
+    }
+
+    if ( j == end )
+    {
+      remaining_plot_stats--;
+    }
+  } );
 }
 
 void plot_t::write_output_file()
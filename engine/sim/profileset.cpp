@@ -7,11 +7,17 @@
 #include "dbc/dbc.hpp"
 #include "sim_control.hpp"
 #include "sim.hpp"
+#include "work_queue.hpp"
 #include "report/reports.hpp"
 #include "player/player.hpp"
 #include "player/player_talent_points.hpp"
 #include "item/item.hpp"
+#include "util/io.hpp"
 #include "util/string_view.hpp"
+#include "gsl-lite/gsl-lite.hpp"
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
 
 #ifndef SC_NO_THREADING
 
@@ -19,6 +25,8 @@
 #include <iostream>
 #include <memory>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace
 {
@@ -103,9 +111,51 @@ std::string format_time( double seconds, bool milliseconds = true )
   return s.str();
 }
 
-// Deallocating profile_sim is the responsibility of the caller (i.e., profileset driver or
-// worker_t)
-void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*& profile_sim )
+// Mean (and standard deviation of the mean) of the per-iteration metric differences between the
+// profileset and the baseline, over the iterations that share a seed
+void analyze_paired( profileset::profile_result_t&            result,
+                     const std::unordered_map<uint64_t, size_t>& baseline_index,
+                     const extended_sample_data_t*            baseline_data,
+                     const extended_sample_data_t*            data,
+                     const std::vector<uint64_t>&             seeds )
+{
+  if ( ! baseline_data || ! data || baseline_data -> simple || data -> simple ||
+       baseline_data -> data().size() != baseline_index.size() || data -> data().size() != seeds.size() )
+  {
+    return;
+  }
+
+  double sum = 0, sum_sq = 0;
+  size_t n = 0;
+  for ( size_t i = 0; i < seeds.size(); ++i )
+  {
+    auto it = baseline_index.find( seeds[ i ] );
+    if ( it == baseline_index.end() )
+    {
+      continue;
+    }
+
+    double delta = data -> data()[ i ] - baseline_data -> data()[ it -> second ];
+    sum += delta;
+    sum_sq += delta * delta;
+    ++n;
+  }
+
+  if ( n < 2 )
+  {
+    return;
+  }
+
+  double mean = sum / n;
+  double variance = std::max( 0.0, ( sum_sq - n * mean * mean ) / ( n - 1 ) );
+
+  result.paired_delta( mean )
+    .paired_delta_stddev( std::sqrt( variance / n ) )
+    .paired_iterations( n );
+}
+
+// Apply the profileset settings to a profileset sim. Must be done before the sim is initialized.
+void setup_profileset_sim( sim_t* parent, const profileset::profile_set_t& set, sim_t* profile_sim )
 {
   // Reset random seed for the profileset sims
   profile_sim -> seed = 0;
@@ -124,6 +174,41 @@ void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*&
     profile_sim -> progress_bar.set_phase( set.name() );
   }
 
+  // Replay the baseline iteration seeds, in a fixed number of iterations per thread so every seed is
+  // simulated once. Every thread runs an uncollected first iteration on top of its share of the
+  // seeds, and has at least one seed to replay. Racing rounds replay the first seeds only.
+  if ( parent -> profileset_paired && ! parent -> paired_seeds.empty() )
+  {
+    auto n_iterations = parent -> paired_seeds.size();
+    if ( set.race_iterations() > 0 )
+    {
+      n_iterations = std::min( n_iterations, set.race_iterations() );
+    }
+
+    profile_sim -> threads = std::max( 1, std::min( profile_sim -> threads, as<int>( n_iterations ) ) );
+    profile_sim -> paired_baseline = &parent -> paired_seeds;
+    profile_sim -> strict_work_queue = 1;
+    profile_sim -> work_queue -> init( as<int>( n_iterations ) + profile_sim -> threads );
+    profile_sim -> target_error = 0;
+  }
+  // Racing rounds simulate on a fixed iteration budget
+  else if ( set.race_iterations() > 0 )
+  {
+    profile_sim -> work_queue -> init( as<int>( set.race_iterations() ) );
+    profile_sim -> target_error = 0;
+  }
+}
+
+// Deallocating profile_sim is the responsibility of the caller (i.e., profileset driver or
+// worker_t)
+void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*& profile_sim )
+{
+  // Sims prepared ahead of time have been set up before initialization
+  if ( ! profile_sim -> initialized )
+  {
+    setup_profileset_sim( parent, set, profile_sim );
+  }
+
   auto ret = profile_sim -> execute();
   if ( ret )
   {
@@ -141,8 +226,18 @@ void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*&
   }
 
   const auto player = profile_sim -> player_no_pet_list[ parent->profileset_report_player_index ];
+  const auto parent_player = parent -> player_no_pet_list[ parent->profileset_report_player_index ];
   auto progress = profile_sim -> progress( nullptr, 0 );
 
+  std::unordered_map<uint64_t, size_t> baseline_index;
+  if ( profile_sim -> paired_baseline )
+  {
+    for ( size_t i = 0; i < parent -> paired_seeds.size(); ++i )
+    {
+      baseline_index.emplace( parent -> paired_seeds[ i ], i );
+    }
+  }
+
   range::for_each( parent -> profileset_metric, [ & ]( scale_metric_e metric ) {
     auto data = profileset::metric_data( player, metric );
 
@@ -156,11 +251,16 @@ void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*&
       .stddev( data.std_dev )
       .mean_stddev( data.mean_std_dev )
       .iterations( progress.current_iterations );
+
+    if ( ! baseline_index.empty() )
+    {
+      analyze_paired( set.result( metric ), baseline_index, profileset::metric_sample_data( parent_player, metric ),
+                      profileset::metric_sample_data( player, metric ), profile_sim -> paired_seeds );
+    }
   } );
 
   if ( ! parent -> profileset_output_data.empty() )
   {
-    const auto parent_player = parent -> player_no_pet_list[ parent->profileset_report_player_index ];
     range::for_each( parent -> profileset_output_data, [ & ]( const std::string& option ) {
         save_output_data( set, parent_player, player, option );
     } );
@@ -173,7 +273,11 @@ void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*&
   parent -> analyze_time += profile_sim -> analyze_time;
   parent -> event_mgr.total_events_processed += profile_sim -> event_mgr.total_events_processed;
 
-  set.cleanup_options();
+  // Profilesets still in the race are simulated again in the next round
+  if ( set.race_iterations() == 0 )
+  {
+    set.cleanup_options();
+  }
 }
 
 // Figure out if the option defines new actor(s) with their own scope
@@ -190,6 +294,80 @@ bool is_actor_scope( const option_tuple_t& opt )
   } );
 }
 
+// Profileset output data stats, as written to and read from shard result files
+struct shard_stat_t
+{
+  const char* name;
+  double ( profileset::profile_output_data_t::*get )() const;
+  profileset::profile_output_data_t& ( profileset::profile_output_data_t::*set )( double );
+};
+
+using output_data_t = profileset::profile_output_data_t;
+
+const shard_stat_t shard_stats[] = {
+  { "stamina", &output_data_t::stamina, &output_data_t::stamina },
+  { "agility", &output_data_t::agility, &output_data_t::agility },
+  { "intellect", &output_data_t::intellect, &output_data_t::intellect },
+  { "strength", &output_data_t::strength, &output_data_t::strength },
+  { "crit_rating", &output_data_t::crit_rating, &output_data_t::crit_rating },
+  { "crit_pct", &output_data_t::crit_pct, &output_data_t::crit_pct },
+  { "haste_rating", &output_data_t::haste_rating, &output_data_t::haste_rating },
+  { "haste_pct", &output_data_t::haste_pct, &output_data_t::haste_pct },
+  { "mastery_rating", &output_data_t::mastery_rating, &output_data_t::mastery_rating },
+  { "mastery_pct", &output_data_t::mastery_pct, &output_data_t::mastery_pct },
+  { "versatility_rating", &output_data_t::versatility_rating, &output_data_t::versatility_rating },
+  { "versatility_pct", &output_data_t::versatility_pct, &output_data_t::versatility_pct },
+  { "avoidance_rating", &output_data_t::avoidance_rating, &output_data_t::avoidance_rating },
+  { "avoidance_pct", &output_data_t::avoidance_pct, &output_data_t::avoidance_pct },
+  { "leech_rating", &output_data_t::leech_rating, &output_data_t::leech_rating },
+  { "leech_pct", &output_data_t::leech_pct, &output_data_t::leech_pct },
+  { "speed_rating", &output_data_t::speed_rating, &output_data_t::speed_rating },
+  { "speed_pct", &output_data_t::speed_pct, &output_data_t::speed_pct },
+  { "corruption", &output_data_t::corruption, &output_data_t::corruption },
+  { "corruption_resistance", &output_data_t::corruption_resistance, &output_data_t::corruption_resistance },
+};
+
+double json_double( const rapidjson::Value& obj, const char* name )
+{
+  auto it = obj.FindMember( name );
+  return it != obj.MemberEnd() && it->value.IsNumber() ? it->value.GetDouble() : 0.0;
+}
+
+size_t json_size( const rapidjson::Value& obj, const char* name )
+{
+  auto it = obj.FindMember( name );
+  return it != obj.MemberEnd() && it->value.IsUint64() ? as<size_t>( it->value.GetUint64() ) : 0U;
+}
+
+// Parse "k/n" shard identifier, returns false on malformed input
+bool parse_shard( util::string_view value, unsigned& index, unsigned& count )
+{
+  auto split = util::string_split<util::string_view>( value, "/" );
+  if ( split.size() != 2 )
+  {
+    return false;
+  }
+
+  try
+  {
+    auto k = util::to_unsigned( split[ 0 ] );
+    auto n = util::to_unsigned( split[ 1 ] );
+    if ( n == 0 || k == 0 || k > n )
+    {
+      return false;
+    }
+
+    index = k - 1;
+    count = n;
+  }
+  catch ( const std::exception& )
+  {
+    return false;
+  }
+
+  return true;
+}
+
 } // unnamed
 
 namespace profileset
@@ -297,7 +475,15 @@ profilesets_t::profilesets_t() : m_state( STARTED ), m_mode( SEQUENTIAL ),
     m_control_lock( m_mutex, std::defer_lock ),
     m_max_workers( 0 ), 
     m_work_lock( m_work_mutex, std::defer_lock ),
-    m_total_elapsed()
+    m_total_elapsed(),
+    m_race_work(),
+    m_race_round( 0 ),
+    m_pool( nullptr ),
+    m_prepared_set( nullptr ),
+    m_prepared_sim( nullptr ),
+    m_prepared_error(),
+    m_prepared_task(),
+    m_cleanup_task()
 { 
 
 }
@@ -311,11 +497,12 @@ profilesets_t::~profilesets_t()
     }
   } );
 
-  range::for_each( m_current_work, []( std::unique_ptr<worker_t>& worker ) { worker -> thread().join(); } );
+  // Workers run on the thread pool of the parent sim, iterate() joins them before the pool goes away
 }
 
 profile_set_t::profile_set_t( std::string name, sim_control_t* opts, bool has_output ) :
-  m_name( std::move(name) ), m_options( opts ), m_has_output( has_output ), m_output_data( nullptr )
+  m_name( std::move(name) ), m_options( opts ), m_has_output( has_output ), m_output_data( nullptr ),
+  m_race_iterations( 0 ), m_pruned( false )
 {
 }
 
@@ -380,26 +567,14 @@ profile_result_t& profile_set_t::result( scale_metric_e metric )
 }
 
 worker_t::worker_t( profilesets_t* master, sim_t* p, profile_set_t* ps ) :
-  m_done( false ), m_parent( p ), m_master( master ), m_sim( nullptr ), m_profileset( ps ),
-  m_thread( nullptr )
+  m_done( false ), m_parent( p ), m_master( master ), m_sim( nullptr ), m_profileset( ps )
 {
-  m_thread = new std::thread( [this] { execute(); } );
+  launch( m_parent -> thread_pool );
 }
 
 worker_t::~worker_t()
 {
   delete m_sim;
-  delete m_thread;
-}
-
-std::thread& worker_t::thread()
-{
-  return *m_thread;
-}
-
-const std::thread& worker_t::thread() const
-{
-  return *m_thread;
 }
 
 sim_t* worker_t::sim() const
@@ -407,7 +582,7 @@ sim_t* worker_t::sim() const
   return m_sim;
 }
 
-void worker_t::execute()
+void worker_t::run()
 {
   try
   {
@@ -429,6 +604,17 @@ void worker_t::execute()
   m_master -> notify_worker();
 }
 
+// Number of profilesets to simulate in the current pass through the profilesets
+size_t profilesets_t::n_work() const
+{
+  return m_race_work.empty() ? m_profilesets.size() : m_race_work.size();
+}
+
+const profile_set_t& profilesets_t::work( size_t index ) const
+{
+  return m_race_work.empty() ? *m_profilesets[ index ] : *m_race_work[ index ];
+}
+
 // Count the number of running workers
 size_t profilesets_t::n_workers() const
 {
@@ -448,7 +634,7 @@ void profilesets_t::cleanup_work()
   {
     if ( ( *it ) -> is_done() )
     {
-      ( *it ) -> thread().join();
+      ( *it ) -> join();
 
       auto sim = ( *it ) -> sim();
 
@@ -464,10 +650,126 @@ void profilesets_t::cleanup_work()
   }
 }
 
+// Construct and initialize the sim of a profileset on the thread pool. Only one profileset is
+// prepared at a time.
+void profilesets_t::prepare_work( sim_t* parent, const profile_set_t& set )
+{
+  if ( ! m_pool || m_prepared_task || parent -> canceled )
+  {
+    return;
+  }
+
+  m_prepared_set = &set;
+  m_prepared_sim = nullptr;
+  m_prepared_error = nullptr;
+  m_prepared_task = m_pool -> submit( [ this, parent, &set ] {
+    m_prepared_sim = new sim_t( parent, 0, set.options() );
+    setup_profileset_sim( parent, set, m_prepared_sim );
+
+    try
+    {
+      m_prepared_sim -> init();
+    }
+    catch ( ... )
+    {
+      m_prepared_error = std::current_exception();
+    }
+  } );
+}
+
+// Take the prepared sim of a profileset. Returns nullptr if the profileset was not prepared, or
+// preparing it failed, in which case the caller sets up the sim normally and gets the usual error
+// handling.
+sim_t* profilesets_t::prepared_work( const profile_set_t& set )
+{
+  if ( ! m_prepared_task || m_prepared_set != &set )
+  {
+    finalize_prepared_work();
+    return nullptr;
+  }
+
+  try
+  {
+    m_pool -> wait( m_prepared_task );
+  }
+  catch ( ... )
+  {
+    // Construction failed, nothing to take over
+  }
+
+  m_prepared_task = nullptr;
+  m_prepared_set = nullptr;
+
+  sim_t* profile_sim = m_prepared_sim;
+  m_prepared_sim = nullptr;
+
+  if ( profile_sim && m_prepared_error )
+  {
+    discard_work( profile_sim );
+    profile_sim = nullptr;
+  }
+
+  return profile_sim;
+}
+
+// Destroy a finished profileset sim, on the thread pool if one is in use
+void profilesets_t::discard_work( sim_t* profile_sim )
+{
+  if ( m_cleanup_task )
+  {
+    m_pool -> wait( m_cleanup_task );
+    m_cleanup_task = nullptr;
+  }
+
+  if ( m_pool )
+  {
+    m_cleanup_task = m_pool -> submit( [ profile_sim ] { delete profile_sim; } );
+  }
+  else
+  {
+    delete profile_sim;
+  }
+}
+
+// Wait for outstanding sim preparation and destruction, dropping any unused prepared sim
+void profilesets_t::finalize_prepared_work()
+{
+  if ( m_prepared_task )
+  {
+    try
+    {
+      m_pool -> wait( m_prepared_task );
+    }
+    catch ( ... )
+    {
+    }
+
+    delete m_prepared_sim;
+    m_prepared_sim = nullptr;
+    m_prepared_set = nullptr;
+    m_prepared_task = nullptr;
+  }
+
+  if ( m_cleanup_task )
+  {
+    m_pool -> wait( m_cleanup_task );
+    m_cleanup_task = nullptr;
+  }
+}
+
+// Join all outstanding workers, whether they finished or not. Workers run on the thread pool, so
+// this must happen before the pool is destroyed.
+void profilesets_t::join_work()
+{
+  range::for_each( m_current_work, []( std::unique_ptr<worker_t>& worker ) { worker -> join(); } );
+}
+
 // Wait until we have all the work done
 void profilesets_t::finalize_work()
 {
-  // Nothing to finalize for sequential profileset model
+  finalize_prepared_work();
+
+  // Nothing else to finalize for sequential profileset model
   if ( m_mode == SEQUENTIAL )
   {
     return;
@@ -493,21 +795,35 @@ void profilesets_t::finalize_work()
   }
 }
 
-void profilesets_t::generate_work( sim_t* parent, std::unique_ptr<profile_set_t>& ptr_set )
+void profilesets_t::generate_work( sim_t* parent, profile_set_t& set )
 {
   if ( m_mode == SEQUENTIAL )
   {
-    auto original_opts = parent -> control;
+    sim_t* profile_sim = prepared_work( set );
+    if ( ! profile_sim )
+    {
+      auto original_opts = parent -> control;
 
-    parent -> control = ptr_set -> options();
+      parent -> control = set.options();
 
-    sim_t* profile_sim = new sim_t( parent );
+      profile_sim = new sim_t( parent );
 
-    parent -> control = original_opts;
+      parent -> control = original_opts;
+    }
 
-    simulate_profileset( parent, *ptr_set, profile_sim );
+    // Set up the next profileset while this one simulates
+    m_control_lock.lock();
+    const profile_set_t* next_set = m_work_index < n_work() ? &work( m_work_index ) : nullptr;
+    m_control_lock.unlock();
 
-    delete profile_sim;
+    if ( next_set )
+    {
+      prepare_work( parent, *next_set );
+    }
+
+    simulate_profileset( parent, set, profile_sim );
+
+    discard_work( profile_sim );
   }
   // Parallel processing
   else
@@ -526,7 +842,7 @@ void profilesets_t::generate_work( sim_t* parent, std::unique_ptr<profile_set_t>
       // Output profileset progressbar whenever we finish anything
       output_progressbar( parent );
 
-      m_current_work.push_back( std::make_unique<worker_t>( this, parent, ptr_set.get() ) );
+      m_current_work.push_back( std::make_unique<worker_t>( this, parent, &set ) );
     }
 
     m_work_lock.unlock();
@@ -622,6 +938,18 @@ void profilesets_t::initialize( sim_t* sim )
     return;
   }
 
+  // Merged shard results are read in when the profilesets would be simulated
+  if ( ! sim -> profileset_merge.empty() )
+  {
+    set_state( RUNNING );
+    return;
+  }
+
+  if ( sim -> profileset_shard_count > 1 )
+  {
+    select_shard( sim );
+  }
+
   if ( sim -> profileset_map.empty() )
   {
     set_state( DONE );
@@ -721,7 +1049,7 @@ std::string profilesets_t::current_profileset_name()
     return {};
   }
 
-  std::string profileset_name = m_profilesets[ m_work_index - 1 ] -> name();
+  std::string profileset_name = work( m_work_index - 1 ).name();
   m_control_lock.unlock();
 
   return profileset_name;
@@ -729,14 +1057,32 @@ std::string profilesets_t::current_profileset_name()
 
 bool profilesets_t::iterate( sim_t* parent )
 {
+  if ( ! parent -> profileset_merge.empty() )
+  {
+    return merge_shards( parent );
+  }
+
   if ( parent -> profileset_map.empty() )
   {
-    return true;
+    return write_shard( parent );
   }
 
   auto original_opts = parent -> control;
 
   m_start_time = chrono::wall_clock::now();
+  m_pool = parent -> thread_pool;
+
+  // Pipelined sims and parallel workers must be dealt with while the thread pool is still around,
+  // even on errors
+  auto finalize_pool_work = gsl::finally( [ this ] {
+    finalize_prepared_work();
+    join_work();
+  } );
+
+  if ( parent -> profileset_racing )
+  {
+    iterate_racing( parent );
+  }
 
   while ( ! is_done() )
   {
@@ -762,7 +1108,7 @@ bool profilesets_t::iterate( sim_t* parent )
 
     m_control_lock.unlock();
 
-    generate_work( parent, set );
+    generate_work( parent, *set );
   }
 
   // Wait until the tail-end of the parallel work has been done. Non-parallel processing mode will
@@ -779,9 +1125,549 @@ bool profilesets_t::iterate( sim_t* parent )
 
   set_state( DONE );
 
+  return write_shard( parent );
+}
+
+// Keep every profileset_shard_count'th profileset of the name-ordered profilesets, so every
+// process sharding the same input selects a disjoint set of profilesets.
+void profilesets_t::select_shard( sim_t* sim ) const
+{
+  std::vector<std::string> names;
+  names.reserve( sim -> profileset_map.size() );
+  for ( const auto& entry : sim -> profileset_map )
+  {
+    names.push_back( entry.first );
+  }
+
+  range::sort( names );
+
+  for ( size_t i = 0; i < names.size(); ++i )
+  {
+    if ( i % sim -> profileset_shard_count != sim -> profileset_shard_index )
+    {
+      sim -> profileset_map.erase( names[ i ] );
+    }
+  }
+}
+
+// Write the results of the simulated shard as JSON lines, one line per profileset followed by a
+// trailer line holding the number of profilesets in the shard. Returns false on write failure.
+bool profilesets_t::write_shard( sim_t* sim ) const
+{
+  if ( sim -> profileset_shard_output.empty() || sim -> canceled )
+  {
+    return true;
+  }
+
+  auto shard = fmt::format( "{}/{}", sim -> profileset_shard_index + 1, sim -> profileset_shard_count );
+
+  rapidjson::StringBuffer buffer;
+
+  for ( const auto& set : m_profilesets )
+  {
+    rapidjson::Writer<rapidjson::StringBuffer> writer( buffer );
+
+    writer.StartObject();
+    writer.Key( "profileset" );
+    writer.String( set -> name().c_str() );
+    writer.Key( "shard" );
+    writer.String( shard.c_str() );
+    if ( set -> pruned() )
+    {
+      writer.Key( "pruned" );
+      writer.Bool( true );
+    }
+
+    writer.Key( "metrics" );
+    writer.StartArray();
+    for ( auto metric : sim -> profileset_metric )
+    {
+      const auto& result = set -> result( metric );
+
+      writer.StartObject();
+      writer.Key( "metric" );
+      writer.String( util::scale_metric_type_abbrev( metric ) );
+      writer.Key( "mean" );
+      writer.Double( result.mean() );
+      writer.Key( "median" );
+      writer.Double( result.median() );
+      writer.Key( "min" );
+      writer.Double( result.min() );
+      writer.Key( "max" );
+      writer.Double( result.max() );
+      writer.Key( "first_quartile" );
+      writer.Double( result.first_quartile() );
+      writer.Key( "third_quartile" );
+      writer.Double( result.third_quartile() );
+      writer.Key( "stddev" );
+      writer.Double( result.stddev() );
+      writer.Key( "mean_stddev" );
+      writer.Double( result.mean_stddev() );
+      writer.Key( "iterations" );
+      writer.Uint64( result.iterations() );
+      if ( result.paired_iterations() > 0 )
+      {
+        writer.Key( "paired_delta" );
+        writer.Double( result.paired_delta() );
+        writer.Key( "paired_delta_stddev" );
+        writer.Double( result.paired_delta_stddev() );
+        writer.Key( "paired_iterations" );
+        writer.Uint64( result.paired_iterations() );
+      }
+      writer.EndObject();
+    }
+    writer.EndArray();
+
+    if ( ! sim -> profileset_output_data.empty() )
+    {
+      auto& output_data = set -> output_data();
+
+      writer.Key( "overrides" );
+      writer.StartObject();
+      if ( output_data.race() != RACE_NONE )
+      {
+        writer.Key( "race" );
+        writer.String( util::race_type_string( output_data.race() ) );
+      }
+
+      if ( ! output_data.gear().empty() )
+      {
+        writer.Key( "gear" );
+        writer.StartArray();
+        for ( const auto& item : output_data.gear() )
+        {
+          writer.StartObject();
+          writer.Key( "slot" );
+          writer.String( item.slot_name() );
+          writer.Key( "item_id" );
+          writer.Uint( item.item_id() );
+          writer.Key( "item_level" );
+          writer.Uint( item.item_level() );
+          writer.EndObject();
+        }
+        writer.EndArray();
+      }
+
+      // Stats are only collected if agility is, see save_output_data
+      if ( output_data.agility() )
+      {
+        writer.Key( "stats" );
+        writer.StartObject();
+        for ( const auto& stat : shard_stats )
+        {
+          writer.Key( stat.name );
+          writer.Double( ( output_data.*stat.get )() );
+        }
+        writer.EndObject();
+      }
+      writer.EndObject();
+    }
+
+    writer.EndObject();
+    buffer.Put( '\n' );
+  }
+
+  {
+    rapidjson::Writer<rapidjson::StringBuffer> writer( buffer );
+    writer.StartObject();
+    writer.Key( "profileset_shard" );
+    writer.String( shard.c_str() );
+    writer.Key( "profilesets" );
+    writer.Uint64( m_profilesets.size() );
+    writer.EndObject();
+    buffer.Put( '\n' );
+  }
+
+  if ( sim -> profileset_shard_output == "-" )
+  {
+    fmt::print( "\n{}", util::string_view( buffer.GetString(), buffer.GetSize() ) );
+    std::fflush( stdout );
+    return true;
+  }
+
+  io::ofstream out;
+  out.open( sim -> profileset_shard_output );
+  if ( ! out.is_open() )
+  {
+    sim -> error( "Unable to open profileset shard output file '{}'", sim -> profileset_shard_output );
+    return false;
+  }
+
+  out.write( buffer.GetString(), buffer.GetSize() );
+
+  return true;
+}
+
+// Read in the profileset results of shard result files (or standard input), written by
+// profileset_shard_output. The results are reported as if the profilesets were simulated by this
+// sim. All shards of a single sharded run must be given, and every source must end in a shard
+// trailer.
+//
+// Shard results are taken over as is, nothing is recomputed across shards. With
+// profileset_racing, each shard raced (and pruned) its profilesets against the leader of its own
+// shard only. With profileset_paired, the paired deltas are against the baseline simulated by the
+// shard that produced them.
+bool profilesets_t::merge_shards( sim_t* sim )
+{
+  unsigned n_shards = 0;
+  std::vector<size_t> shard_records, shard_totals;
+  std::vector<bool> shard_seen;
+  std::unordered_set<std::string> names;
+
+  auto parse_record = [ & ]( const std::string& source, const std::string& line ) {
+    rapidjson::Document doc;
+    doc.Parse( line.c_str(), line.size() );
+    if ( doc.HasParseError() || ! doc.IsObject() )
+    {
+      sim -> error( "Malformed profileset shard record in '{}': {}", source, line );
+      return false;
+    }
+
+    auto trailer = doc.HasMember( "profileset_shard" );
+    if ( ! trailer && ( ! doc.HasMember( "shard" ) || ! doc.HasMember( "profileset" ) ||
+                        ! doc.HasMember( "metrics" ) ) )
+    {
+      sim -> error( "Malformed profileset shard record in '{}': {}", source, line );
+      return false;
+    }
+
+    const auto& shard_value = trailer ? doc[ "profileset_shard" ] : doc[ "shard" ];
+    unsigned index = 0, count = 0;
+    if ( ! shard_value.IsString() || ! parse_shard( shard_value.GetString(), index, count ) )
+    {
+      sim -> error( "Invalid profileset shard identifier in '{}'", source );
+      return false;
+    }
+
+    if ( n_shards == 0 )
+    {
+      n_shards = count;
+      shard_records.assign( count, 0 );
+      shard_totals.assign( count, 0 );
+      shard_seen.assign( count, false );
+    }
+    else if ( count != n_shards )
+    {
+      sim -> error( "Profileset shard '{}' of '{}' does not belong to a run of {} shards",
+                    shard_value.GetString(), source, n_shards );
+      return false;
+    }
+
+    if ( trailer )
+    {
+      if ( shard_seen[ index ] )
+      {
+        sim -> error( "Profileset shard {}/{} given more than once", index + 1, n_shards );
+        return false;
+      }
+
+      shard_seen[ index ] = true;
+      shard_totals[ index ] = json_size( doc, "profilesets" );
+      return true;
+    }
+
+    if ( ! doc[ "profileset" ].IsString() || ! doc[ "metrics" ].IsArray() )
+    {
+      sim -> error( "Malformed profileset shard record in '{}': {}", source, line );
+      return false;
+    }
+
+    std::string name = doc[ "profileset" ].GetString();
+    if ( ! names.insert( name ).second )
+    {
+      sim -> error( "Profileset '{}' found in more than one shard record", name );
+      return false;
+    }
+
+    auto set = std::make_unique<profile_set_t>( name, nullptr, false );
+    if ( doc.HasMember( "pruned" ) && doc[ "pruned" ].IsBool() )
+    {
+      set -> pruned( doc[ "pruned" ].GetBool() );
+    }
+
+    for ( const auto& entry : doc[ "metrics" ].GetArray() )
+    {
+      if ( ! entry.IsObject() || ! entry.HasMember( "metric" ) || ! entry[ "metric" ].IsString() )
+      {
+        continue;
+      }
+
+      auto metric = util::parse_scale_metric( entry[ "metric" ].GetString() );
+      if ( metric == SCALE_METRIC_NONE )
+      {
+        sim -> error( "Invalid metric '{}' for profileset '{}'", entry[ "metric" ].GetString(), name );
+        return false;
+      }
+
+      set -> result( metric )
+        .mean( json_double( entry, "mean" ) )
+        .median( json_double( entry, "median" ) )
+        .min( json_double( entry, "min" ) )
+        .max( json_double( entry, "max" ) )
+        .first_quartile( json_double( entry, "first_quartile" ) )
+        .third_quartile( json_double( entry, "third_quartile" ) )
+        .stddev( json_double( entry, "stddev" ) )
+        .mean_stddev( json_double( entry, "mean_stddev" ) )
+        .iterations( json_size( entry, "iterations" ) )
+        .paired_delta( json_double( entry, "paired_delta" ) )
+        .paired_delta_stddev( json_double( entry, "paired_delta_stddev" ) )
+        .paired_iterations( json_size( entry, "paired_iterations" ) );
+    }
+
+    if ( doc.HasMember( "overrides" ) && doc[ "overrides" ].IsObject() )
+    {
+      const auto& ovr = doc[ "overrides" ];
+      auto& output_data = set -> output_data();
+
+      if ( ovr.HasMember( "race" ) && ovr[ "race" ].IsString() )
+      {
+        output_data.race( util::parse_race_type( ovr[ "race" ].GetString() ) );
+      }
+
+      if ( ovr.HasMember( "gear" ) && ovr[ "gear" ].IsArray() )
+      {
+        std::vector<profile_output_data_item_t> gear;
+        for ( const auto& item : ovr[ "gear" ].GetArray() )
+        {
+          if ( ! item.IsObject() || ! item.HasMember( "slot" ) || ! item[ "slot" ].IsString() )
+          {
+            continue;
+          }
+
+          auto slot = util::parse_slot_type( item[ "slot" ].GetString() );
+          if ( slot == SLOT_INVALID )
+          {
+            continue;
+          }
+
+          gear.emplace_back( util::slot_type_string( slot ),
+                             as<unsigned>( json_size( item, "item_id" ) ),
+                             as<unsigned>( json_size( item, "item_level" ) ) );
+        }
+        output_data.gear( gear );
+      }
+
+      if ( ovr.HasMember( "stats" ) && ovr[ "stats" ].IsObject() )
+      {
+        for ( const auto& stat : shard_stats )
+        {
+          ( output_data.*stat.set )( json_double( ovr[ "stats" ], stat.name ) );
+        }
+      }
+    }
+
+    shard_records[ index ]++;
+    m_profilesets.push_back( std::move( set ) );
+
+    return true;
+  };
+
+  auto read_stream = [ & ]( const std::string& source, std::istream& in ) {
+    std::string line;
+    bool has_trailer = false, trailing_records = false;
+    while ( std::getline( in, line ) )
+    {
+      // Shard output written to standard output is interleaved with other simc output
+      auto pos = line.find( "{\"profileset" );
+      if ( pos == std::string::npos )
+      {
+        continue;
+      }
+
+      if ( ! parse_record( source, line.substr( pos ) ) )
+      {
+        return false;
+      }
+
+      // The trailer is written last, records after it belong to a shard that did not finish
+      bool trailer = line.compare( pos, 19, "{\"profileset_shard\"" ) == 0;
+      has_trailer = has_trailer || trailer;
+      trailing_records = ! trailer;
+    }
+
+    if ( ! has_trailer || trailing_records )
+    {
+      sim -> error( "Profileset shard input '{}' is missing a shard trailer", source );
+      return false;
+    }
+
+    return true;
+  };
+
+  for ( const auto& source : sim -> profileset_merge )
+  {
+    if ( source == "-" )
+    {
+      if ( ! read_stream( "<stdin>", std::cin ) )
+      {
+        return false;
+      }
+
+      continue;
+    }
+
+    io::ifstream in;
+    in.open( source );
+    if ( ! in.is_open() )
+    {
+      sim -> error( "Unable to open profileset shard file '{}'", source );
+      return false;
+    }
+
+    if ( ! read_stream( source, in ) )
+    {
+      return false;
+    }
+  }
+
+  if ( n_shards == 0 )
+  {
+    sim -> error( "No profileset shard records found in profileset_merge input" );
+    return false;
+  }
+
+  for ( unsigned i = 0; i < n_shards; ++i )
+  {
+    if ( ! shard_seen[ i ] )
+    {
+      sim -> error( "Profileset shard {}/{} is missing or incomplete", i + 1, n_shards );
+      return false;
+    }
+
+    if ( shard_records[ i ] != shard_totals[ i ] )
+    {
+      sim -> error( "Profileset shard {}/{} has {} profileset results, expected {}",
+                    i + 1, n_shards, shard_records[ i ], shard_totals[ i ] );
+      return false;
+    }
+  }
+
+  range::sort( m_profilesets, []( const profileset_entry_t& l, const profileset_entry_t& r ) {
+    return l -> name() < r -> name();
+  } );
+
+  m_work_index = m_profilesets.size();
+
+  set_state( DONE );
+
   return true;
 }
 
+// Successive halving race. Every profileset is first simulated on a small iteration budget.
+// Profilesets whose confidence interval falls below the leader's are dropped, and the budget of the
+// survivors grows each round. The final round simulates the survivors on their normal budget.
+// Leaves the work index past the last profileset, so the regular profileset loop has nothing to do.
+bool profilesets_t::iterate_racing( sim_t* parent )
+{
+  // Racing ranks all profilesets against each other, so wait for initialization to finish
+  range::for_each( m_thread, []( std::thread& thread ) {
+    if ( thread.joinable() )
+    {
+      thread.join();
+    }
+  } );
+
+  std::vector<profile_set_t*> active;
+  range::transform( m_profilesets, std::back_inserter( active ), []( const profileset_entry_t& p ) {
+    return p.get();
+  } );
+
+  // The baseline is the best estimate of the iterations a full profileset simulation needs
+  auto full_iterations = parent -> progress( nullptr, 0 ).current_iterations;
+  auto iterations = as<double>( std::max( 1, parent -> profileset_racing_iterations ) );
+  auto growth = std::max( 1.5, parent -> profileset_racing_growth );
+  m_race_round = 0;
+
+  while ( true )
+  {
+    bool final_round = active.size() <= 1 || iterations >= full_iterations;
+    range::for_each( active, [ final_round, iterations ]( profile_set_t* set ) {
+      set -> race_iterations( final_round ? 0 : as<size_t>( iterations ) );
+    } );
+
+    m_control_lock.lock();
+    m_race_work = active;
+    m_work_index = 0;
+    m_total_elapsed = {};
+    m_control_lock.unlock();
+
+    while ( ! is_done() && m_work_index < m_race_work.size() )
+    {
+      m_control_lock.lock();
+      auto set = m_race_work[ m_work_index++ ];
+      m_control_lock.unlock();
+
+      generate_work( parent, *set );
+    }
+
+    finalize_work();
+
+    if ( final_round || is_done() )
+    {
+      break;
+    }
+
+    output_progressbar( parent );
+
+    // Drop profilesets that are clearly behind, and they will not be simulated any further
+    auto n_pruned = prune( parent );
+    active.clear();
+    range::copy_if( m_race_work, std::back_inserter( active ), []( const profile_set_t* set ) {
+      return ! set -> pruned();
+    } );
+
+    if ( ! parent -> profileset_work_threads )
+    {
+      fmt::print( "Profileset racing round {}: {} simulated, {} pruned, {} iterations\n", m_race_round + 1,
+                  m_race_work.size(), n_pruned, as<size_t>( iterations ) );
+    }
+
+    iterations *= growth;
+    ++m_race_round;
+  }
+
+  m_control_lock.lock();
+  m_race_work.clear();
+  m_work_index = m_profilesets.size();
+  m_control_lock.unlock();
+
+  return ! is_done();
+}
+
+// Prune profilesets of the current racing round whose confidence interval of the primary metric
+// lies entirely on the worse side of the confidence interval of the round leader. Returns the
+// number of profilesets pruned.
+size_t profilesets_t::prune( const sim_t* parent )
+{
+  if ( m_race_work.empty() )
+  {
+    return 0;
+  }
+
+  auto z = parent -> confidence_estimator;
+  // Orient the primary metric so that larger is always better
+  double sign = util::scale_metric_is_lower_better( m_race_work.front() -> result().metric() ) ? -1.0 : 1.0;
+  auto leader = *std::max_element( m_race_work.begin(), m_race_work.end(),
+    [ sign ]( const profile_set_t* l, const profile_set_t* r ) {
+      return sign * l -> result().mean() < sign * r -> result().mean();
+  } );
+
+  double bound = sign * leader -> result().mean() - z * leader -> result().mean_stddev();
+  size_t n_pruned = 0;
+
+  range::for_each( m_race_work, [ bound, z, sign, &n_pruned ]( profile_set_t* set ) {
+    const auto& result = set -> result();
+    if ( sign * result.mean() + z * result.mean_stddev() < bound )
+    {
+      set -> pruned( true );
+      set -> cleanup_options();
+      ++n_pruned;
+    }
+  } );
+
+  return n_pruned;
+}
+
 void profilesets_t::notify_worker()
 {
   m_work.notify_one();
@@ -812,10 +1698,15 @@ void profilesets_t::output_progressbar( const sim_t* parent ) const
 
   s << "Profilesets (" << m_max_workers << "*" << parent -> profileset_work_threads << "): ";
 
+  if ( ! m_race_work.empty() )
+  {
+    s << "Round " << m_race_round + 1 << ": ";
+  }
+
   auto done = done_profilesets();
-  auto pct = done / as<double>( m_profilesets.size() );
+  auto pct = done / as<double>( n_work() );
 
-  s << done << "/" << m_profilesets.size() << " ";
+  s << done << "/" << n_work() << " ";
 
   std::string status = "[";
   status.insert( 1, parent -> progress_bar.steps, '.' );
@@ -836,7 +1727,7 @@ void profilesets_t::output_progressbar( const sim_t* parent ) const
 
   auto average_per_sim = chrono::to_fp_seconds(m_total_elapsed) / as<double>( done );
   auto elapsed = chrono::elapsed_fp_seconds( m_start_time );
-  auto work_left = m_profilesets.size() - done;
+  auto work_left = n_work() - done;
   auto time_left = work_left * ( average_per_sim / m_max_workers );
 
   // Average time per done simulation
@@ -955,6 +1846,23 @@ void create_options( sim_t* sim )
 
   sim -> add_option( opt_int( "profileset_work_threads", sim -> profileset_work_threads ) );
   sim -> add_option( opt_int( "profileset_init_threads", sim -> profileset_init_threads ) );
+  sim -> add_option( opt_bool( "profileset_paired", sim -> profileset_paired ) );
+  sim -> add_option( opt_bool( "profileset_racing", sim -> profileset_racing ) );
+  sim -> add_option( opt_int( "profileset_racing_iterations", sim -> profileset_racing_iterations, 1, std::numeric_limits<int>::max() ) );
+  sim -> add_option( opt_float( "profileset_racing_growth", sim -> profileset_racing_growth, 1.5, 100.0 ) );
+  sim -> add_option( opt_func( "profileset_shard", []( sim_t*             sim,
+                                                       util::string_view,
+                                                       util::string_view value ) {
+    if ( ! parse_shard( value, sim -> profileset_shard_index, sim -> profileset_shard_count ) )
+    {
+      sim -> error( "Invalid profileset shard '{}', expected k/n with 1 <= k <= n", value );
+      return false;
+    }
+
+    return true;
+  } ) );
+  sim -> add_option( opt_string( "profileset_shard_output", sim -> profileset_shard_output ) );
+  sim -> add_option( opt_list( "profileset_merge", sim -> profileset_merge ) );
 }
 
 statistical_data_t collect( const extended_sample_data_t& c )
@@ -963,6 +1871,29 @@ statistical_data_t collect( const extended_sample_data_t& c )
            c.percentile( 0.75 ), c.max(), c.std_dev, c.mean_std_dev };
 }
 
+// Per-iteration samples of a metric, nullptr for composite metrics
+const extended_sample_data_t* metric_sample_data( const player_t* player, scale_metric_e metric )
+{
+  const auto& d = player -> collected_data;
+
+  switch ( metric )
+  {
+    case SCALE_METRIC_DPS:       return &d.dps;
+    case SCALE_METRIC_DPSE:      return &d.dpse;
+    case SCALE_METRIC_HPS:       return &d.hps;
+    case SCALE_METRIC_HPSE:      return &d.hpse;
+    case SCALE_METRIC_APS:       return &d.aps;
+    case SCALE_METRIC_DPSP:      return &d.prioritydps;
+    case SCALE_METRIC_DTPS:      return &d.dtps;
+    case SCALE_METRIC_DMG_TAKEN: return &d.dmg_taken;
+    case SCALE_METRIC_HTPS:      return &d.htps;
+    case SCALE_METRIC_DEATHS:    return &d.deaths;
+    case SCALE_METRIC_TIME:      return &d.fight_length;
+    case SCALE_METRIC_RAID_DPS:  return &player->sim->raid_dps;
+    default:                     return nullptr;
+  }
+}
+
 statistical_data_t metric_data( const player_t* player, scale_metric_e metric )
 {
   const auto& d = player -> collected_data;
@@ -6,6 +6,7 @@
 #define SC_PROFILESET_HH
 
 #include <array>
+#include <exception>
 #include <memory>
 #include <vector>
 #include <string>
@@ -18,6 +19,7 @@
 
 #include "option.hpp"
 #include "util/chrono.hpp"
+#include "util/concurrency.hpp"
 #include "util/generic.hpp"
 #include "sc_enums.hpp"
 
@@ -56,14 +58,19 @@ class profile_result_t
   double         m_stddev;
   double         m_mean_stddev;
   size_t         m_iterations;
+  double         m_paired_delta;
+  double         m_paired_delta_stddev;
+  size_t         m_paired_iterations;
 
 public:
   profile_result_t() : m_metric( SCALE_METRIC_NONE ), m_mean( 0 ), m_median( 0 ), m_min( 0 ),
-    m_max( 0 ), m_1stquartile( 0 ), m_3rdquartile( 0 ), m_stddev( 0 ), m_mean_stddev(0), m_iterations( 0 )
+    m_max( 0 ), m_1stquartile( 0 ), m_3rdquartile( 0 ), m_stddev( 0 ), m_mean_stddev(0), m_iterations( 0 ),
+    m_paired_delta( 0 ), m_paired_delta_stddev( 0 ), m_paired_iterations( 0 )
   { }
 
   profile_result_t( scale_metric_e m ) : m_metric( m ), m_mean( 0 ), m_median( 0 ), m_min( 0 ),
-    m_max( 0 ), m_1stquartile( 0 ), m_3rdquartile( 0 ), m_stddev( 0 ), m_mean_stddev(0), m_iterations( 0 )
+    m_max( 0 ), m_1stquartile( 0 ), m_3rdquartile( 0 ), m_stddev( 0 ), m_mean_stddev(0), m_iterations( 0 ),
+    m_paired_delta( 0 ), m_paired_delta_stddev( 0 ), m_paired_iterations( 0 )
   { }
 
   scale_metric_e metric() const
@@ -127,6 +134,28 @@ public:
   profile_result_t& iterations( size_t i )
   { m_iterations = i; return *this; }
 
+  // Mean of the per-iteration differences to the baseline, for profilesets replaying the baseline
+  // iteration seeds (profileset_paired=1)
+  double paired_delta() const
+  { return m_paired_delta; }
+
+  profile_result_t& paired_delta( double v )
+  { m_paired_delta = v; return *this; }
+
+  // Standard deviation of the mean of the paired differences
+  double paired_delta_stddev() const
+  { return m_paired_delta_stddev; }
+
+  profile_result_t& paired_delta_stddev( double v )
+  { m_paired_delta_stddev = v; return *this; }
+
+  // Number of paired iterations, zero if the result is not paired
+  size_t paired_iterations() const
+  { return m_paired_iterations; }
+
+  profile_result_t& paired_iterations( size_t i )
+  { m_paired_iterations = i; return *this; }
+
   statistical_data_t statistical_data() const
   { return { m_min, m_1stquartile, m_median, m_mean, m_3rdquartile, m_max, m_stddev, m_mean_stddev }; }
 };
@@ -383,6 +412,8 @@ class profile_set_t
   bool                                   m_has_output;
   std::vector<profile_result_t>          m_results;
   std::unique_ptr<profile_output_data_t> m_output_data;
+  size_t                                 m_race_iterations;
+  bool                                   m_pruned;
 
 public:
   profile_set_t( std::string name, sim_control_t* opts, bool has_output );
@@ -399,6 +430,20 @@ public:
   bool has_output() const
   { return m_has_output; }
 
+  // Iteration budget of the current racing round, zero for the normal simulation budget
+  size_t race_iterations() const
+  { return m_race_iterations; }
+
+  profile_set_t& race_iterations( size_t v )
+  { m_race_iterations = v; return *this; }
+
+  // Dropped from the race, results are from the round the profileset was dropped in
+  bool pruned() const
+  { return m_pruned; }
+
+  profile_set_t& pruned( bool v )
+  { m_pruned = v; return *this; }
+
   const profile_result_t& result( scale_metric_e metric = SCALE_METRIC_NONE ) const;
 
   profile_result_t& result( scale_metric_e metric );
@@ -417,7 +462,8 @@ public:
   }
 };
 
-class worker_t
+// Profileset worker, simulates a single profileset on the parent's thread pool
+class worker_t : private sc_thread_t
 {
   bool           m_done;
   sim_t*         m_parent;
@@ -425,15 +471,14 @@ class worker_t
 
   sim_t*         m_sim;
   profile_set_t* m_profileset;
-  std::thread*   m_thread;
+
+  void run() override;
 
 public:
   worker_t( profilesets_t*, sim_t*, profile_set_t* );
-  ~worker_t();
+  ~worker_t() override;
 
-  const std::thread& thread() const;
-  std::thread& thread();
-  void execute();
+  using sc_thread_t::join;
 
   bool is_done() const
   { return m_done == true; }
@@ -489,6 +534,20 @@ private:
   // Parallel profileset stats collection
   chrono::wall_clock::time_point         m_start_time;
   chrono::wall_clock::duration           m_total_elapsed;
+
+  // Profilesets simulated in the current racing round, empty when not racing
+  std::vector<profile_set_t*>            m_race_work;
+  size_t                                 m_race_round;
+
+  // Sequential profileset sim pipelining. The sim of the next profileset is constructed and
+  // initialized on the thread pool while the current one simulates, and finished sims are destroyed
+  // on the thread pool.
+  thread_pool_t*                         m_pool;
+  const profile_set_t*                   m_prepared_set;
+  sim_t*                                 m_prepared_sim;
+  std::exception_ptr                     m_prepared_error;
+  thread_pool_t::task_ptr                m_prepared_task;
+  thread_pool_t::task_ptr                m_cleanup_task;
 #endif
 
   int max_name_length() const;
@@ -498,9 +557,24 @@ private:
   void set_state( state new_state );
 
   size_t n_workers() const;
-  void generate_work( sim_t*, std::unique_ptr<profile_set_t>& );
+  size_t n_work() const;
+  const profile_set_t& work( size_t index ) const;
+  void generate_work( sim_t*, profile_set_t& );
   void cleanup_work();
   void finalize_work();
+  void join_work();
+
+  void prepare_work( sim_t* parent, const profile_set_t& set );
+  sim_t* prepared_work( const profile_set_t& set );
+  void discard_work( sim_t* profile_sim );
+  void finalize_prepared_work();
+
+  bool iterate_racing( sim_t* parent );
+  size_t prune( const sim_t* parent );
+
+  void select_shard( sim_t* sim ) const;
+  bool write_shard( sim_t* sim ) const;
+  bool merge_shards( sim_t* sim );
 
   sim_control_t* create_sim_options( const sim_control_t*, const std::vector<std::string>& opts, unsigned main_actor_index );
 public:
@@ -541,6 +615,7 @@ void create_options( sim_t* sim );
 
 statistical_data_t collect( const extended_sample_data_t& c );
 statistical_data_t metric_data( const player_t* player, scale_metric_e metric );
+const extended_sample_data_t* metric_sample_data( const player_t* player, scale_metric_e metric );
 void save_output_data( profile_set_t& profileset, const player_t* parent_player, const player_t* player, const std::string& option );
 
 // Filter non-profilest options into a new control object, caller is responsible for deleting the
@@ -151,17 +151,16 @@ void reforge_plot_t::analyze_stats()
     }
   }
 
-  for ( size_t i = 0; i < stat_mod_combos.size(); i++ )
-  {
-    if ( sim->is_canceled() )
-      break;
+  std::vector<std::vector<plot_data_t>> delta_results( stat_mod_combos.size() );
 
-    std::vector<plot_data_t> delta_result( stat_mod_combos[ i ].size() + 1 );
+  sim->execute_delta_sims( stat_mod_combos.size(), [ this, &stat_mod_combos, &delta_results ]( size_t i ) {
+    std::vector<plot_data_t>& delta_result = delta_results[ i ];
+    delta_result.resize( stat_mod_combos[ i ].size() + 1 );
 
-    current_reforge_sim = new sim_t( sim );
+    auto reforge_sim = new sim_t( sim );
     if ( reforge_plot_iterations > 0 )
     {
-      current_reforge_sim->work_queue->init( reforge_plot_iterations );
+      reforge_sim->work_queue->init( reforge_plot_iterations );
     }
 
     std::stringstream s;
@@ -170,7 +169,7 @@ void reforge_plot_t::analyze_stats()
       stat_e stat = reforge_plot_stat_indices[ j ];
       int mod = stat_mod_combos[ i ][ j ];
 
-      current_reforge_sim->enchant.add_stat( stat, mod );
+      reforge_sim->enchant.add_stat( stat, mod );
       delta_result[ j ].value = mod;
       delta_result[ j ].error = 0;
 
@@ -181,29 +180,38 @@ void reforge_plot_t::analyze_stats()
       }
     }
 
-    current_stat_combo = as<int>( i );
-    current_reforge_sim->progress_bar.set_base( s.str() );
-    current_reforge_sim->execute();
+    reforge_sim->progress_bar.set_base( s.str() );
+
+    // Progress follows the first of the concurrently executing sims
+    if ( !current_reforge_sim )
+    {
+      current_stat_combo = as<int>( i );
+      current_reforge_sim = reforge_sim;
+    }
+
+    return reforge_sim;
+  }, [ this, &stat_mod_combos, &delta_results ]( size_t i, sim_t* reforge_sim ) {
+    std::vector<plot_data_t>& delta_result = delta_results[ i ];
 
     for ( player_t* player : sim->players_by_name )
     {
-      if ( current_reforge_sim )
-      {
-        plot_data_t& data = delta_result[ stat_mod_combos[ i ].size() ];
-        player_t* delta_p = current_reforge_sim->find_player( player->name() );
+      plot_data_t& data = delta_result[ stat_mod_combos[ i ].size() ];
+      player_t* delta_p = reforge_sim->find_player( player->name() );
 
-        scaling_metric_data_t scaling_data = delta_p->scaling_for_metric( player->sim->scaling->scaling_metric );
+      scaling_metric_data_t scaling_data = delta_p->scaling_for_metric( player->sim->scaling->scaling_metric );
 
-        data.value = scaling_data.value;
-        data.error = scaling_data.stddev * current_reforge_sim->confidence_estimator;
+      data.value = scaling_data.value;
+      data.error = scaling_data.stddev * reforge_sim->confidence_estimator;
 
-        player->reforge_plot_data.push_back( delta_result );
-      }
+      player->reforge_plot_data.push_back( delta_result );
     }
 
-    delete current_reforge_sim;
-    current_reforge_sim = nullptr;
-  }
+    if ( current_reforge_sim == reforge_sim )
+    {
+      current_reforge_sim = nullptr;
+    }
+    delete reforge_sim;
+  } );
 }
 
 void reforge_plot_t::write_output_file()
@@ -241,115 +241,156 @@ void scale_factor_control_t::analyze_stats()
   baseline_sim = sim; // Take the current sim as baseline
   mutex.unlock();
 
+  // Every stat needs a delta sim, centered stats also a reference sim of their own. Entries are
+  // consumed in order, the delta sim of a centered stat is held until its reference sim is done.
+  struct entry_t
+  {
+    stat_e stat;
+    bool center;
+    bool ref;
+  };
+  std::vector<entry_t> entries;
   for ( const auto& stat : stats_to_scale )
   {
-    if ( sim -> is_canceled() ) break;
+    bool center = center_scale_delta && ! stat_may_cap( stat );
+    entries.push_back( { stat, center, false } );
+    if ( center )
+      entries.push_back( { stat, center, true } );
+  }
 
-    current_scaling_stat = stat; // Stat we're scaling over
+  sim_t* pending_delta = nullptr;
 
-    double scale_delta = stats->get_stat( stat );
+  sim -> execute_delta_sims( entries.size(), [ this, &entries ]( size_t i ) {
+    const entry_t& entry = entries[ i ];
+    double scale_delta = stats->get_stat( entry.stat );
     assert ( scale_delta );
 
-    bool center = center_scale_delta && ! stat_may_cap( stat );
+    auto s = new sim_t( sim );
+
+    s -> progress_bar.set_base( ( entry.ref ? std::string( "Ref " ) : std::string() ) +
+                                util::stat_type_abbrev( entry.stat ) );
+
+    s -> scaling -> scale_stat = entry.stat;
+    if ( entry.ref )
+      s -> scaling -> scale_value = -( scale_delta / 2 );
+    else
+      s -> scaling -> scale_value = +scale_delta / ( entry.center ? 2 : 1 );
 
     mutex.lock();
-    ref_sim = baseline_sim;
-    delta_sim = new sim_t( sim );
+    current_scaling_stat = entry.stat; // Stat we're scaling over
+    if ( entry.ref )
+      ref_sim = s;
+    else
+      delta_sim = s;
     mutex.unlock();
 
-    delta_sim -> progress_bar.set_base( util::stat_type_abbrev( stat ) );
+    return s;
+  }, [ this, &entries, &pending_delta ]( size_t i, sim_t* s ) {
+    const entry_t& entry = entries[ i ];
+    if ( entry.center && ! entry.ref )
+    {
+      pending_delta = s;
+      return;
+    }
 
-    delta_sim -> scaling -> scale_stat = stat;
-    delta_sim -> scaling -> scale_value = +scale_delta / ( center ? 2 : 1 );
-    delta_sim -> execute();
+    sim_t* stat_delta_sim = entry.ref ? pending_delta : s;
+    sim_t* stat_ref_sim = entry.ref ? s : baseline_sim;
+    pending_delta = nullptr;
 
-    if ( center )
-    {
-      mutex.lock();
-      ref_sim = new sim_t( sim );
-      mutex.unlock();
+    analyze_stat( entry.stat, stat_ref_sim, stat_delta_sim );
 
-      ref_sim -> progress_bar.set_base( std::string( "Ref " ) + util::stat_type_abbrev( stat ) );
+    mutex.lock();
+    if ( ref_sim == stat_ref_sim )
+      ref_sim = nullptr;
+    if ( delta_sim == stat_delta_sim )
+      delta_sim = nullptr;
+    if ( stat_ref_sim != baseline_sim && stat_ref_sim != sim )
+      delete stat_ref_sim;
+    delete stat_delta_sim;
+    remaining_scaling_stats--;
+    mutex.unlock();
+  } );
 
-      ref_sim -> scaling -> scale_stat = stat;
-      ref_sim -> scaling -> scale_value = center ? -( scale_delta / 2 ) : 0;
-      ref_sim -> execute();
-    }
+  // A canceled run can leave the delta sim of a centered stat without its reference sim
+  if ( pending_delta )
+  {
+    mutex.lock();
+    if ( delta_sim == pending_delta )
+      delta_sim = nullptr;
+    delete pending_delta;
+    mutex.unlock();
+  }
 
-    for ( auto* p : sim->players_by_name )
-    {
-       if ( ! p -> scaling -> scales_with[ stat ] ) continue;
+  if ( baseline_sim != sim ) delete baseline_sim;
+  baseline_sim = nullptr;
+}
 
-      player_t*   ref_p =   ref_sim -> find_player( p -> name() );
-      player_t* delta_p = delta_sim -> find_player( p -> name() );
-      assert( ref_p && "Reference Player not found" );
-      assert( delta_p && "Delta player not found" );
+// scaling_t::analyze_stat ==================================================
 
-      double divisor = scale_delta;
+void scale_factor_control_t::analyze_stat( stat_e stat, sim_t* stat_ref_sim, sim_t* stat_delta_sim )
+{
+  double scale_delta = stats->get_stat( stat );
+  bool center = center_scale_delta && ! stat_may_cap( stat );
 
-      if ( delta_p -> invert_scaling )
-        divisor = -divisor;
+  for ( auto* p : sim->players_by_name )
+  {
+     if ( ! p -> scaling -> scales_with[ stat ] ) continue;
 
-      if ( divisor < 0.0 ) divisor += ref_p -> scaling -> over_cap[ stat ];
+    player_t*   ref_p =   stat_ref_sim -> find_player( p -> name() );
+    player_t* delta_p = stat_delta_sim -> find_player( p -> name() );
+    assert( ref_p && "Reference Player not found" );
+    assert( delta_p && "Delta player not found" );
 
-      for ( scale_metric_e sm = SCALE_METRIC_NONE; sm < SCALE_METRIC_MAX; sm++ )
-      {
+    double divisor = scale_delta;
 
-        double delta_score = delta_p -> scaling_for_metric( sm ).value;
-        double   ref_score = ref_p -> scaling_for_metric( sm ).value;
+    if ( delta_p -> invert_scaling )
+      divisor = -divisor;
 
-        double delta_error = delta_p -> scaling_for_metric( sm ).stddev * delta_sim -> confidence_estimator;
-        double   ref_error = ref_p -> scaling_for_metric( sm ).stddev * ref_sim -> confidence_estimator;
+    if ( divisor < 0.0 ) divisor += ref_p -> scaling -> over_cap[ stat ];
 
-        double score = ( delta_score - ref_score ) / divisor;
-        double error = delta_error * delta_error + ref_error * ref_error;
+    for ( scale_metric_e sm = SCALE_METRIC_NONE; sm < SCALE_METRIC_MAX; sm++ )
+    {
 
-        if ( error > 0 )
-          error = sqrt( error );
+      double delta_score = delta_p -> scaling_for_metric( sm ).value;
+      double   ref_score = ref_p -> scaling_for_metric( sm ).value;
 
-        error = fabs( error / divisor );
+      double delta_error = delta_p -> scaling_for_metric( sm ).stddev * stat_delta_sim -> confidence_estimator;
+      double   ref_error = ref_p -> scaling_for_metric( sm ).stddev * stat_ref_sim -> confidence_estimator;
 
-        if ( fabs( divisor ) < 1.0 ) // For things like Weapon Speed, show the gain per 0.1 speed gain rather than every 1.0.
-        {
-          score /= 10.0;
-          error /= 10.0;
-          delta_error /= 10.0;
-        }
+      double score = ( delta_score - ref_score ) / divisor;
+      double error = delta_error * delta_error + ref_error * ref_error;
 
-        analyze_ability_stats( stat, divisor, p, ref_p, delta_p );
+      if ( error > 0 )
+        error = sqrt( error );
 
-        if ( center )
-          p -> scaling -> scaling_compare_error[ sm ].set_stat( stat, error );
-        else
-          p -> scaling -> scaling_compare_error[ sm ].set_stat( stat, delta_error / divisor );
+      error = fabs( error / divisor );
 
-        p -> scaling -> scaling[ sm ].set_stat( stat, score );
-        p -> scaling -> scaling_error[ sm ].set_stat( stat, error );
+      if ( fabs( divisor ) < 1.0 ) // For things like Weapon Speed, show the gain per 0.1 speed gain rather than every 1.0.
+      {
+        score /= 10.0;
+        error /= 10.0;
+        delta_error /= 10.0;
       }
-    }
 
-    if ( debug_scale_factors )
-    {
-      fmt::print( "\nref_sim report for '{}'...\n", util::stat_type_string( stat ) );
-      report::print_text( ref_sim, true );
-      fmt::print( "\ndelta_sim report for '{}'...\n", util::stat_type_string( stat ) );
-      report::print_text( delta_sim, true );
-    }
+      analyze_ability_stats( stat, divisor, p, ref_p, delta_p );
 
-    mutex.lock();
-    if ( ref_sim != baseline_sim && ref_sim != sim )
-    {
-      delete ref_sim;
-      ref_sim = nullptr;
+      if ( center )
+        p -> scaling -> scaling_compare_error[ sm ].set_stat( stat, error );
+      else
+        p -> scaling -> scaling_compare_error[ sm ].set_stat( stat, delta_error / divisor );
+
+      p -> scaling -> scaling[ sm ].set_stat( stat, score );
+      p -> scaling -> scaling_error[ sm ].set_stat( stat, error );
     }
-    delete delta_sim;  
-    delta_sim  = nullptr;
-    remaining_scaling_stats--;
-    mutex.unlock();
   }
 
-  if ( baseline_sim != sim ) delete baseline_sim;
-  baseline_sim = nullptr;
+  if ( debug_scale_factors )
+  {
+    fmt::print( "\nref_sim report for '{}'...\n", util::stat_type_string( stat ) );
+    report::print_text( stat_ref_sim, true );
+    fmt::print( "\ndelta_sim report for '{}'...\n", util::stat_type_string( stat ) );
+    report::print_text( stat_delta_sim, true );
+  }
 }
 
 /* Creates scale factors for stats_t objects
@@ -391,23 +432,37 @@ void scale_factor_control_t::analyze_lag()
     fmt::print( "\nGenerating scale factors for lag...\n" );
   }
 
-  if ( center_scale_delta )
-  {
-    ref_sim = new sim_t( sim );
-    ref_sim -> scaling -> scale_stat = STAT_MAX;
-    ref_sim -> execute();
-  }
-  else
+  if ( ! center_scale_delta )
   {
     ref_sim = sim;
     ref_sim -> scaling -> scale_stat = STAT_MAX;
   }
 
-  delta_sim = new sim_t( sim );
-  delta_sim ->     gcd_lag.mean += 100_ms;
-  delta_sim -> channel_lag.mean += 200_ms;
-  delta_sim -> scaling -> scale_stat = STAT_MAX;
-  delta_sim -> execute();
+  // The delta sim, and the reference sim if centered, execute together
+  sim -> execute_delta_sims( center_scale_delta ? 2 : 1, [ this ]( size_t i ) {
+    auto s = new sim_t( sim );
+    s -> scaling -> scale_stat = STAT_MAX;
+    if ( i == 0 )
+    {
+      s ->     gcd_lag.mean += 100_ms;
+      s -> channel_lag.mean += 200_ms;
+    }
+
+    mutex.lock();
+    ( i == 0 ? delta_sim : ref_sim ) = s;
+    mutex.unlock();
+
+    return s;
+  }, []( size_t, sim_t* ) {} );
+
+  if ( ! delta_sim || ! ref_sim )
+  {
+    // Canceled before the sims were created
+    if ( ref_sim != sim ) delete ref_sim;
+    delete delta_sim;
+    delta_sim = ref_sim = nullptr;
+    return;
+  }
 
   for ( auto* p : sim->players_by_name )
   {
@@ -49,6 +49,7 @@ struct scale_factor_control_t
   void init_deltas();
   void analyze();
   void analyze_stats();
+  void analyze_stat( stat_e, sim_t* ref, sim_t* delta );
   void analyze_ability_stats( stat_e, double, player_t*, player_t*, player_t* );
   void analyze_lag();
   void normalize();
@@ -15,6 +15,7 @@
 #include "player/pet.hpp"
 #include "player/player.hpp"
 #include "player/spawner_base.hpp"
+#include "player/stats.hpp"
 #include "player/unique_gear.hpp"
 #include "report/json/report_configuration.hpp"
 #include "report/reports.hpp"
@@ -36,15 +37,87 @@
 #include "util/xml.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
 #include <iostream>
 #include <random>
 #include <sstream>
+#ifndef SC_NO_THREADING
+#include <thread>
+#endif
 #ifdef SC_WINDOWS
 #include <direct.h>
 #endif
 
 namespace { // UNNAMED NAMESPACE ============================================
 
+// Run fn( i ) for each i in [0, n) on up to n_workers threads (including the calling thread). The
+// helper threads come from the thread pool if one is given. The first exception thrown by fn is
+// rethrown on the calling thread once all workers are done.
+template <typename Fn>
+void parallel_for( thread_pool_t* pool, size_t n_workers, size_t n, Fn&& fn )
+{
+#ifndef SC_NO_THREADING
+  n_workers = std::min( n_workers, n );
+  if ( n_workers > 1 )
+  {
+    std::atomic<size_t> next { 0 };
+    std::vector<std::exception_ptr> errors( n_workers );
+    auto worker = [ & ]( size_t worker_idx ) {
+      try
+      {
+        for ( size_t i = next++; i < n; i = next++ )
+        {
+          fn( i );
+        }
+      }
+      catch ( ... )
+      {
+        errors[ worker_idx ] = std::current_exception();
+      }
+    };
+
+    if ( pool )
+    {
+      std::vector<thread_pool_t::task_ptr> tasks;
+      for ( size_t i = 1; i < n_workers; ++i )
+      {
+        tasks.push_back( pool -> submit( [ &worker, i ] { worker( i ); } ) );
+      }
+      worker( 0 );
+      range::for_each( tasks, [ pool ]( const thread_pool_t::task_ptr& t ) { pool -> wait( t ); } );
+    }
+    else
+    {
+      std::vector<std::thread> workers;
+      for ( size_t i = 1; i < n_workers; ++i )
+      {
+        workers.emplace_back( worker, i );
+      }
+      worker( 0 );
+      range::for_each( workers, []( std::thread& t ) { t.join(); } );
+    }
+
+    for ( const auto& error : errors )
+    {
+      if ( error )
+      {
+        std::rethrow_exception( error );
+      }
+    }
+    return;
+  }
+#else
+  (void)pool;
+  (void)n_workers;
+#endif
+
+  for ( size_t i = 0; i < n; ++i )
+  {
+    fn( i );
+  }
+}
+
 // Comparator for iteration data entry sorting (see analyze_iteration_data)
 bool iteration_data_cmp( const iteration_data_entry_t& a,
                          const iteration_data_entry_t& b )
@@ -90,16 +163,37 @@ bool iteration_data_cmp_r( const iteration_data_entry_t& a,
   return true;
 }
 
-struct seed_predicate_t
+// Whether entry belongs in a bounded heap of at most capacity entries. The heap top is the entry
+// that is evicted first, i.e., the least extreme one.
+template <typename Compare>
+bool iteration_data_qualifies( const std::vector<iteration_data_entry_t>& heap, size_t capacity,
+                               const iteration_data_entry_t& entry, Compare cmp )
 {
-  uint64_t seed;
+  if ( heap.size() < capacity )
+  {
+    return true;
+  }
 
-  seed_predicate_t( uint64_t seed_ ) : seed( seed_ )
-  { }
+  return ! heap.empty() && cmp( entry, heap.front() );
+}
 
-  bool operator()( const iteration_data_entry_t& e ) const
-  { return e.seed == seed; }
-};
+// Insert a qualifying entry into the heap, evicting the top entry if the heap is full
+template <typename Compare>
+void iteration_data_push( std::vector<iteration_data_entry_t>& heap, size_t capacity,
+                          std::unordered_multiset<uint64_t>& seeds, const iteration_data_entry_t& entry,
+                          Compare cmp )
+{
+  if ( heap.size() >= capacity )
+  {
+    std::pop_heap( heap.begin(), heap.end(), cmp );
+    seeds.erase( seeds.find( heap.back().seed ) );
+    heap.pop_back();
+  }
+
+  heap.push_back( entry );
+  std::push_heap( heap.begin(), heap.end(), cmp );
+  seeds.insert( entry.seed );
+}
 
 // parse_debug_seed =========================================================
 
@@ -835,6 +929,44 @@ bool parse_process_priority( sim_t*             sim,
   return true;
 }
 
+bool parse_event_queue( sim_t*             sim,
+                        util::string_view /* name */,
+                        util::string_view value )
+{
+  sim -> event_mgr.queue_type = parse_event_queue_type( value );
+
+  return true;
+}
+
+bool parse_data_collection( sim_t*             sim,
+                            util::string_view /* name */,
+                            util::string_view value )
+{
+  if ( util::str_compare_ci( value, "auto" ) )
+  {
+    sim -> data_collection = data_collection_level::AUTO;
+  }
+  else if ( util::str_compare_ci( value, "metric" ) )
+  {
+    sim -> data_collection = data_collection_level::METRIC;
+  }
+  else if ( util::str_compare_ci( value, "summary" ) )
+  {
+    sim -> data_collection = data_collection_level::SUMMARY;
+  }
+  else if ( util::str_compare_ci( value, "full" ) )
+  {
+    sim -> data_collection = data_collection_level::FULL;
+  }
+  else
+  {
+    sim -> error( "Invalid data_collection '{}', valid values are auto, metric, summary and full.", value );
+    return false;
+  }
+
+  return true;
+}
+
 bool parse_target_error_role( sim_t * sim,
                               util::string_view /* name */,
                               util::string_view value )
@@ -992,8 +1124,9 @@ struct sim_safeguard_end_event_t : public sim_end_event_t
 
 struct resource_timeline_collect_event_t : public event_t
 {
+  // One sample per timeline bin
   resource_timeline_collect_event_t( sim_t& s ) :
-    event_t( s, timespan_t::from_seconds( 1 ) )
+    event_t( s, timespan_t::from_seconds( s.timeline_bin_size ) )
   {
   }
   const char* name() const override
@@ -1363,19 +1496,20 @@ struct compare_name
 // sims progress with the main thread's current index.
 sim_progress_t work_queue_t::progress( int idx )
 {
-  G l(m);
   size_t current_index = idx;
   if ( idx < 0 )
   {
-    current_index = index;
+    current_index = index.load( std::memory_order_relaxed );
   }
 
   if ( current_index >= _total_work.size() )
   {
-    return sim_progress_t{ _work.back(), _projected_work.back() };
+    return sim_progress_t{ _done_work.back().load( std::memory_order_relaxed ),
+                           _projected_work.back().load( std::memory_order_relaxed ) };
   }
 
-  return sim_progress_t{ _work[ current_index ], _projected_work[ current_index ] };
+  return sim_progress_t{ _done_work[ current_index ].load( std::memory_order_relaxed ),
+                         _projected_work[ current_index ].load( std::memory_order_relaxed ) };
 }
 
 // ==========================================================================
@@ -1386,6 +1520,7 @@ sim_progress_t work_queue_t::progress( int idx )
 
 sim_t::sim_t()
   : event_mgr( this ),
+    state_generations(),
     out_log( *this, &std::cout, sim_ostream_t::no_close() ),
     out_debug( *this, &std::cout, sim_ostream_t::no_close() ),
     debug( false ),
@@ -1393,6 +1528,7 @@ sim_t::sim_t()
     canceled( false ),
     cleanup_threads( false ),
     initialized( false ),
+    iterate_succeeded( false ),
     fixed_time( true ),
     save_profiles( false ),
     save_profile_with_actions( true ),
@@ -1443,6 +1579,12 @@ sim_t::sim_t()
     ignite_sampling_delta( 200_ms ),
     optimize_expressions( 2 ),
     optimize_expressions_rounds( 1 ),
+    compile_expressions( true ),
+    precombat_decision_cache( false ),
+    apl_profile( false ),
+    apl_readiness_index( false ),
+    memoize_expressions( false ),
+    apl_profile_sample_rate( 16 ),
     current_slot( -1 ),
     optimal_raid( 0 ),
     log( 0 ),
@@ -1489,8 +1631,15 @@ sim_t::sim_t()
     seed( 0 ),
     deterministic( 0 ),
     strict_work_queue( 0 ),
+    counter_rng( false ),
+    counter_rng_iteration( 0 ),
+    counter_rng_key( 0 ),
+    iteration_key( 0 ),
+    iteration_seed( 0 ),
     average_range( true ),
     average_gauss( false ),
+    rng_ziggurat( false ),
+    rng_batch( false ),
     fight_style(),
     add_waves( 0 ),
     overrides( overrides_t() ),
@@ -1517,8 +1666,17 @@ sim_t::sim_t()
     merge_time(),
     init_time(),
     analyze_time(),
+    spinup_time(),
+    partition_start_time(),
     report_iteration_data( 0.025 ),
     min_report_iteration_data( -1 ),
+    iteration_data_count( 0 ),
+    iteration_data_capacity( 0 ),
+    profileset_paired( false ),
+    paired_seeds(),
+    paired_baseline( nullptr ),
+    paired_offset( 0 ),
+    paired_replay( false ),
     report_progress( 1 ),
     bloodlust_percent( 0 ),
     bloodlust_time( 0_ms ),
@@ -1534,10 +1692,13 @@ sim_t::sim_t()
     save_raid_summary( 0 ),
     save_gear_comments( 0 ),
     statistics_level( 1 ),
+    data_collection( data_collection_level::AUTO ),
+    statistics_sketch( 0 ),
     separate_stats_by_actions( 0 ),
     report_raid_summary( 0 ),
     buff_uptime_timeline( 1 ),
     buff_stack_uptime_timeline( 1 ),
+    timeline_bin_size( 1.0 ),
     json_full_states( 0 ),
     decorated_tooltips( -1 ),
     allow_potions( true ),
@@ -1555,6 +1716,9 @@ sim_t::sim_t()
     merge_enemy_priority_dmg( false ),
     // Multi-Threading
     threads( 0 ),
+    thread_pinning( false ),
+    thread_pool( nullptr ),
+    concurrent_delta_sims( 2 ),
     thread_index( 0 ),
     process_priority( computer_process::BELOW_NORMAL ),
     work_queue( new work_queue_t() ),
@@ -1578,6 +1742,13 @@ sim_t::sim_t()
     profileset_enabled( false ),
     profileset_work_threads( 0 ),
     profileset_init_threads( 1 ),
+    profileset_racing( false ),
+    profileset_racing_iterations( 100 ),
+    profileset_racing_growth( 4.0 ),
+    profileset_shard_index( 0 ),
+    profileset_shard_count( 1 ),
+    profileset_shard_output(),
+    profileset_merge(),
     profilesets( std::make_unique<profileset::profilesets_t>() )
 {
   item_db_sources.assign( std::begin( default_item_db_sources ), std::end( default_item_db_sources ) );
@@ -1609,6 +1780,13 @@ sim_t::sim_t( sim_t* p, int index ) : sim_t()
   // Inherit reporting directives from parent
   report_progress = parent -> report_progress;
 
+  // Schedule onto the same worker threads as the parent
+  thread_pool = parent -> thread_pool;
+
+  // Profileset options are filtered from child sims, inherit iteration pairing explicitly
+  profileset_paired = parent -> profileset_paired;
+  paired_baseline = parent -> paired_baseline;
+
   // Inherit 'plot' settings from parent because are set outside of the config file
   enchant = parent -> enchant;
 
@@ -1636,6 +1814,13 @@ sim_t::sim_t( sim_t* p, int index, sim_control_t* control ) : sim_t()
   // Inherit reporting directives from parent
   report_progress = parent -> report_progress;
 
+  // Schedule onto the same worker threads as the parent
+  thread_pool = parent -> thread_pool;
+
+  // Profileset options are filtered from child sims, inherit iteration pairing explicitly
+  profileset_paired = parent -> profileset_paired;
+  paired_baseline = parent -> paired_baseline;
+
   // Inherit 'plot' settings from parent because are set outside of the config file
   enchant = parent -> enchant;
 
@@ -1658,6 +1843,13 @@ sim_t::~sim_t()
 
 double sim_t::iteration_time_adjust()
 {
+  // Counter-based seeding draws the length from the iteration seed, so a replayed iteration
+  // (iterations=1) gets the same length as the original one.
+  if ( counter_rng )
+  {
+    return rng().range( 1.0 - vary_combat_length, 1.0 + vary_combat_length );
+  }
+
   if ( iterations <= 1 )
     return 1.0;
 
@@ -1668,8 +1860,9 @@ double sim_t::iteration_time_adjust()
   // used. Will generate more fair fight length distribution when reasonable (<0.5) target_error
   // values are chosen, and removes issues with pathological cases where high values are used (high
   // enough for analyze_error_interval to bound the number of iterations done, instead of the
-  // target_error).
-  if ( target_error != 0 )
+  // target_error). Paired sims also draw the length from the iteration seed, so that the baseline and
+  // profileset iterations sharing a seed use the same length.
+  if ( target_error != 0 || profileset_paired )
   {
     return rng().range( 1.0 - vary_combat_length, 1.0 + vary_combat_length );
   }
@@ -1768,6 +1961,15 @@ bool sim_t::is_canceled() const
   return canceled;
 }
 
+// sim_t::work_queue_is_strict ==============================================
+
+// Whether every thread simulates a fixed share of the iterations from a work queue of its own.
+// Deterministic sims need this, unless the iteration seeds do not depend on the thread.
+bool sim_t::work_queue_is_strict() const
+{
+  return ( deterministic && ! counter_rng ) || strict_work_queue;
+}
+
 // sim_t::cancel_iteration ==================================================
 
 void sim_t::cancel_iteration()
@@ -1799,8 +2001,41 @@ void sim_t::reset()
 {
   print_debug( "Resetting Simulator" );
 
-  if ( deterministic )
-    seed = rng().reseed();
+  // Replay the baseline iteration seeds. Takes precedence over the other seeding schemes, as the
+  // baseline already recorded the seeds they produced. Replayed and counter-based iteration seeds
+  // leave the base seed untouched.
+  if ( paired_baseline )
+  {
+    // The first iteration of a thread is not collected (unless it is the only one), and runs on a
+    // seed of its own. Collected iterations past the end of the baseline are not paired.
+    bool collected = iterations == 1 || current_iteration >= 1;
+    size_t index = paired_offset + as<size_t>( current_iteration ) - ( iterations == 1 ? 0 : 1 );
+    paired_replay = collected && index < paired_baseline -> size();
+    if ( paired_replay )
+    {
+      iteration_seed = ( *paired_baseline )[ index ];
+      rng().seed( iteration_seed );
+      rng().reset();
+    }
+    else
+    {
+      iteration_seed = rng().reseed();
+    }
+  }
+  else if ( counter_rng )
+  {
+    iteration_seed = rng::counter_seed( counter_rng_key, iteration_key, as<uint32_t>( current_index ) );
+    rng().seed( iteration_seed );
+    rng().reset();
+  }
+  else if ( deterministic )
+  {
+    seed = iteration_seed = rng().reseed();
+  }
+  else if ( profileset_paired )
+  {
+    iteration_seed = rng().reseed();
+  }
 
   event_mgr.reset();
 
@@ -1935,6 +2170,9 @@ void sim_t::combat_begin()
     }
   }
 
+  // Class modules may set up actor state directly when combat begins
+  bump_state_generation();
+
   if ( requires_regen_event )
     make_event<regen_event_t>( *this, *this );
 
@@ -2045,7 +2283,11 @@ void sim_t::datacollection_begin()
        p -> datacollection_begin();
     }
   }
-  make_event<resource_timeline_collect_event_t>( *this, *this );
+
+  if ( data_collection == data_collection_level::FULL )
+  {
+    make_event<resource_timeline_collect_event_t>( *this, *this );
+  }
 }
 
 // sim_t::datacollection_end ================================================
@@ -2074,10 +2316,13 @@ void sim_t::datacollection_end()
     }
   }
 
-  for ( size_t i = 0; i < buff_list.size(); ++i )
+  if ( data_collection >= data_collection_level::SUMMARY )
   {
-    buff_t* b = buff_list[ i ];
-    b -> datacollection_end();
+    for ( size_t i = 0; i < buff_list.size(); ++i )
+    {
+      buff_t* b = buff_list[ i ];
+      b -> datacollection_end();
+    }
   }
 
   total_dmg.add( iteration_dmg );
@@ -2087,37 +2332,72 @@ void sim_t::datacollection_end()
   total_absorb.add( iteration_absorb );
   raid_aps.add( current_time() != timespan_t::zero() ? iteration_absorb / current_time().total_seconds() : 0 );
 
-  if ( deterministic && report_iteration_data > 0 && current_iteration > 0 &&
+  // One seed per collected sample, so merged seeds stay aligned with the merged sample data. An
+  // unpaired sample of a profileset sim records no seed, which leaves the profileset unpaired.
+  if ( profileset_paired && ( ! paired_baseline || paired_replay ) )
+  {
+    paired_seeds.push_back( iteration_seed );
+  }
+
+  if ( ( deterministic || counter_rng ) && report_iteration_data > 0 && current_iteration > 0 &&
        current_time() > timespan_t::zero() )
   {
     // TODO: Metric should be selectable
+    // Counter-based iterations are reported by their key, replayable with counter_rng_iteration and
+    // counter_rng_key as the seed
     iteration_data_entry_t entry( iteration_dmg / current_time().total_seconds(),
-        current_time().total_seconds(), seed, current_iteration );
-    for ( auto* t : target_list )
-    {
-       // Once we start hitting adds (instead of real enemies), break out as those don't have real
-      // hitpoints.
-      if ( t -> is_add() )
-      {
-        break;
-      }
+        current_time().total_seconds(), iteration_seed,
+        counter_rng ? iteration_key : current_iteration );
 
-      entry.add_health( static_cast< uint64_t >( t -> resources.initial[ RESOURCE_HEALTH ] ) );
-    }
-
-    if ( std::find_if( iteration_data.begin(), iteration_data.end(),
-                       seed_predicate_t( seed ) ) != iteration_data.end() )
+    // A duplicate seed replays an iteration, which can only matter if the original is still held
+    if ( iteration_data_seeds.count( iteration_seed ) )
     {
       errorf( "[Thread-%d] Duplicate seed %llu found on iteration %u, skipping ...",
-          thread_index, seed, current_iteration );
+          thread_index, iteration_seed, current_iteration );
     }
     else
     {
-      iteration_data.push_back( entry );
+      iteration_data_count++;
+
+      // Most iterations are not among the extremes, skip them before collecting target health
+      if ( iteration_data_qualifies( low_iteration_data, iteration_data_capacity, entry, iteration_data_cmp_r ) ||
+           iteration_data_qualifies( high_iteration_data, iteration_data_capacity, entry, iteration_data_cmp ) )
+      {
+        for ( auto* t : target_list )
+        {
+          // Once we start hitting adds (instead of real enemies), break out as those don't have real
+          // hitpoints.
+          if ( t -> is_add() )
+          {
+            break;
+          }
+
+          entry.add_health( static_cast< uint64_t >( t -> resources.initial[ RESOURCE_HEALTH ] ) );
+        }
+
+        add_iteration_data( entry );
+      }
     }
   }
 }
 
+// sim_t::add_iteration_data ================================================
+
+void sim_t::add_iteration_data( const iteration_data_entry_t& entry )
+{
+  if ( iteration_data_qualifies( low_iteration_data, iteration_data_capacity, entry, iteration_data_cmp_r ) )
+  {
+    iteration_data_push( low_iteration_data, iteration_data_capacity, iteration_data_seeds, entry,
+                         iteration_data_cmp_r );
+  }
+
+  if ( iteration_data_qualifies( high_iteration_data, iteration_data_capacity, entry, iteration_data_cmp ) )
+  {
+    iteration_data_push( high_iteration_data, iteration_data_capacity, iteration_data_seeds, entry,
+                         iteration_data_cmp );
+  }
+}
+
 // sim_t::analyze_error =====================================================
 
 void sim_t::analyze_error()
@@ -2126,8 +2406,8 @@ void sim_t::analyze_error()
   if ( target_error <= 0 ) return;
   if ( current_iteration < 1 ) return;
 
-  work_queue -> lock();
-
+  // Work queue progress is read lock-free, worker threads keep iterating while thread 0 checks
+  // for convergence.
   // First iterations of each thread are considered statistically insignificant and not
   // collected
   int n_iterations = work_queue -> progress().current_iterations - threads;
@@ -2140,7 +2420,6 @@ void sim_t::analyze_error()
 
   if ( n_iterations < analyze_error_interval * ( analyze_number + 1 ) )
   {
-    work_queue -> unlock();
     return;
   }
 
@@ -2153,19 +2432,24 @@ void sim_t::analyze_error()
 
   bool is_multiactor_metric = false;
 
+  // Convergence is checked on a snapshot of the running target metric moments, so the check costs
+  // the same regardless of the number of iterations done, and the metric lock is held only for
+  // the copy.
+  auto target_moments = []( player_collected_data_t& cd ) {
+    AUTO_LOCK( cd.target_metric_mutex );
+    return cd.target_metric.moments();
+  };
+
   if ( single_actor_batch )
   {
     auto p = player_no_pet_list[ current_index ];
-    auto& cd = p -> collected_data;
-    AUTO_LOCK( cd.target_metric_mutex );
-    if ( cd.target_metric.size() != 0 )
+    auto moments = target_moments( p -> collected_data );
+    if ( moments.count() != 0 )
     {
-      cd.target_metric.analyze_basics();
-      cd.target_metric.analyze_variance();
-      current_mean = cd.target_metric.mean();
+      current_mean = moments.mean();
       if ( current_mean != 0 )
       {
-        current_error = sim_t::distribution_mean_error( *this, cd.target_metric ) / current_mean;
+        current_error = sim_t::distribution_mean_error( *this, moments ) / current_mean;
       }
     }
   }
@@ -2178,23 +2462,20 @@ void sim_t::analyze_error()
     for ( size_t i = 0; i < actor_list.size(); i++ )
     {
       player_t* p = actor_list[i];
-      player_collected_data_t& cd = p -> collected_data;
-      AUTO_LOCK( cd.target_metric_mutex );
-      if ( cd.target_metric.size() != 0 )
+      auto moments = target_moments( p -> collected_data );
+      if ( moments.count() != 0 )
       {
-        cd.target_metric.analyze_basics();
-        cd.target_metric.analyze_variance();
-        double mean = cd.target_metric.mean();
+        double mean = moments.mean();
         if ( mean != 0 )
         {
           if ( is_multiactor_metric )
            {
-             double error = sim_t::distribution_mean_error( *this, cd.target_metric );
+             double error = sim_t::distribution_mean_error( *this, moments );
              current_error += error;
           }
           else
           {
-             double error = sim_t::distribution_mean_error( *this, cd.target_metric ) / mean;
+             double error = sim_t::distribution_mean_error( *this, moments ) / mean;
              if ( error > current_error )
               current_error = error;
           }
@@ -2246,8 +2527,6 @@ void sim_t::analyze_error()
       }
     }
   }
-
-  work_queue -> unlock();
 }
 
 /**
@@ -2690,7 +2969,36 @@ void sim_t::init()
       seed  = uint64_t(rd()) | (uint64_t(rd()) << 32);
     }
   }
+  _rng.batch( rng_batch );
   _rng.seed( seed + thread_index );
+  _rng.ziggurat( rng_ziggurat );
+  counter_rng_key = seed;
+
+  // Resolve the data collection level before any collectors are created. Threads collect what
+  // their parent does, so they can be merged. Profileset, scale factor and plot sims (parented
+  // sims of their own) only report their metric, ability scale factors need the summary level.
+  if ( parent && thread_index > 0 )
+  {
+    data_collection = parent -> data_collection;
+  }
+  else if ( data_collection == data_collection_level::AUTO )
+  {
+    if ( profileset_enabled || parent )
+    {
+      data_collection = statistics_level >= 3 ? data_collection_level::SUMMARY : data_collection_level::METRIC;
+    }
+    else
+    {
+      data_collection = data_collection_level::FULL;
+    }
+  }
+
+  if ( data_collection < data_collection_level::FULL )
+  {
+    report_details = 0;
+    buff_uptime_timeline = 0;
+    buff_stack_uptime_timeline = 0;
+  }
 
   if (   queue_lag.stddev == 0_ms )   queue_lag.stddev =   queue_lag.mean * 0.25;
   if (     gcd_lag.stddev == 0_ms )     gcd_lag.stddev =     gcd_lag.mean * 0.25;
@@ -2886,6 +3194,8 @@ void sim_t::init()
 
   if ( report_precision < 0 ) report_precision = 2;
 
+  // simulation_length samples are needed as-is to build timeline divisors
+  raid_dps.change_sketch( statistics_sketch );
   raid_dps.reserve( std::min( iterations, 10000 ) );
   simulation_length.reserve( std::min( iterations, 10000 ) );
 
@@ -2983,9 +3293,24 @@ void sim_t::analyze()
   for ( size_t i = 0; i < actor_list.size(); i++ )
   {
     actor_list[ i ] -> pre_analyze_hook();
-    actor_list[ i ] -> collected_data.analyze( *actor_list[ i ] );
   }
 
+  // Collected data of an actor is self-contained, so it is analyzed in parallel across actors. The
+  // stats samples are sorted in the same pass, leaving the sequential stats analysis below
+  // without the sorting cost.
+  parallel_for( thread_pool, as<size_t>( threads ), actor_list.size(), [ this ]( size_t i ) {
+    auto p = actor_list[ i ];
+    p -> collected_data.analyze( *p );
+
+    for ( auto s : p -> stats_list )
+    {
+      s -> actual_amount.sort();
+      s -> total_amount.sort();
+      s -> portion_aps.sort();
+      s -> portion_apse.sort();
+    }
+  } );
+
   for ( size_t i = 0; i < actor_list.size(); i++ )
     actor_list[ i ] -> analyze( *this );
 
@@ -3005,35 +3330,58 @@ void sim_t::analyze()
   analyze_time = chrono::elapsed(start_time);
 }
 
+/**
+ * Number of lowest and highest iterations to report out of n collected iterations
+ */
+size_t sim_t::iteration_data_entries( size_t n ) const
+{
+  size_t min_entries = ( min_report_iteration_data == -1 ) ? 5 : static_cast<size_t>( min_report_iteration_data );
+  double n_pct = report_iteration_data / ( report_iteration_data > 1 ? 100.0 : 1.0 );
+  return std::max( min_entries, static_cast<size_t>( std::ceil( n * n_pct ) ) );
+}
+
 /**
  * Build a N-highest/lowest iteration table for deterministic so they can be
  * replayed
  */
 void sim_t::analyze_iteration_data()
 {
-  // Only enabled for deterministic simulations for now
-  if ( ! deterministic || report_iteration_data == 0 )
+  // Only enabled for deterministic and counter-based simulations for now
+  if ( ! ( deterministic || counter_rng ) || report_iteration_data == 0 )
   {
     return;
   }
 
-  range::sort( iteration_data, iteration_data_cmp_r );
-
-  size_t min_entries = ( min_report_iteration_data == -1 ) ? 5 : static_cast<size_t>( min_report_iteration_data );
-  double n_pct = report_iteration_data / ( report_iteration_data > 1 ? 100.0 : 1.0 );
-  size_t n_entries = std::max( min_entries, static_cast<size_t>( std::ceil( iteration_data.size() * n_pct ) ) );
+  size_t n_entries = iteration_data_entries( iteration_data_count );
+  assert( n_entries <= iteration_data_capacity && "Iteration data heaps sized for fewer iterations" );
 
   // If low + high entries is more than we have data for, we will just print
-  // all data out
-  if ( n_entries * 2 > iteration_data.size() )
+  // all data out. The heaps then hold every collected iteration between them.
+  if ( n_entries * 2 > iteration_data_count )
   {
+    iteration_data = std::move( low_iteration_data );
+    for ( auto& entry : high_iteration_data )
+    {
+      if ( range::find_if( iteration_data, [ &entry ]( const iteration_data_entry_t& e ) {
+             return e.seed == entry.seed;
+           } ) == iteration_data.end() )
+      {
+        iteration_data.push_back( std::move( entry ) );
+      }
+    }
+
+    range::sort( iteration_data, iteration_data_cmp_r );
+    low_iteration_data.clear();
+    high_iteration_data.clear();
     return;
   }
 
-  std::copy( iteration_data.begin(), iteration_data.begin() + n_entries, std::back_inserter( low_iteration_data ) );
   range::sort( low_iteration_data, iteration_data_cmp_r );
-  std::copy( iteration_data.end() - n_entries, iteration_data.end(), std::back_inserter( high_iteration_data ) );
+  low_iteration_data.erase( low_iteration_data.begin() + std::min( n_entries, low_iteration_data.size() ),
+                            low_iteration_data.end() );
   range::sort( high_iteration_data, iteration_data_cmp );
+  high_iteration_data.erase( high_iteration_data.begin() + std::min( n_entries, high_iteration_data.size() ),
+                             high_iteration_data.end() );
 }
 
 
@@ -3054,11 +3402,25 @@ bool sim_t::iterate()
     return false;
   }
 
+  // Child sims report how long it took from partitioning until they were ready to iterate
+  if ( parent && thread_index > 0 )
+  {
+    spinup_time = chrono::elapsed( parent -> partition_start_time );
+  }
+
   progress_bar.init();
 
   activate_actors();
 
+  work_queue_t::batch_t work_batch;
   bool more_work = true;
+  // Independent work queues number their tickets from zero, offset them by the collected iterations
+  // of the preceding threads so that iteration keys stay unique.
+  uint64_t ticket_offset = work_queue_is_strict() ? paired_offset : 0;
+  // The first iteration of a thread is not collected (unless it is the only one), give it a key of
+  // its own outside of the ticket range.
+  iteration_key = iterations == 1 ? counter_rng_iteration
+                                  : std::numeric_limits<uint64_t>::max() - thread_index;
   do
   {
     ++current_iteration;
@@ -3075,8 +3437,10 @@ bool sim_t::iterate()
     auto old_active = current_index;
     if ( ! canceled )
     {
-      current_index = work_queue -> pop();
-      more_work = work_queue -> more_work();
+      current_index = work_queue -> pop( work_batch );
+      more_work = work_queue -> more_work( work_batch );
+      iteration_key = work_batch.ticket >= 0 ? ticket_offset + work_batch.ticket
+                                             : std::numeric_limits<uint64_t>::max() - thread_index;
 
       if ( more_work && current_index != old_active )
       {
@@ -3141,8 +3505,16 @@ void sim_t::do_pause()
   }
 }
 
+thread_local std::vector<std::string>* sim_t::merge_errors = nullptr;
+
 void sim_t::set_error(std::string error)
 {
+    if ( merge_errors )
+    {
+      merge_errors -> push_back( std::move( error ) );
+      return;
+    }
+
     util::replace_all( error, "\n", "" );
     fmt::print( stderr, "{}\n", error );
     std::fflush( stderr );
@@ -3150,11 +3522,10 @@ void sim_t::set_error(std::string error)
     error_list.push_back( std::move( error ) );
 }
 
-/// merge sims
-void sim_t::merge( sim_t& other_sim )
+/// merge sims, statically created actors are merged using up to n_workers threads
+void sim_t::merge( sim_t& other_sim, size_t n_workers )
 {
   auto_lock_t auto_lock( merge_mutex );
-  const auto start_time = chrono::wall_clock::now();
 
   if ( scaling -> scale_stat == STAT_NONE &&
        scaling -> calculate_scale_factors == 0 &&
@@ -3167,7 +3538,14 @@ void sim_t::merge( sim_t& other_sim )
   }
 
   iterations += other_sim.iterations;
-  work_per_thread[ other_sim.thread_index ] = other_sim.work_done;
+  if ( work_per_thread.size() < other_sim.work_per_thread.size() )
+  {
+    work_per_thread.resize( other_sim.work_per_thread.size() );
+  }
+  for ( size_t i = 0; i < other_sim.work_per_thread.size(); ++i )
+  {
+    work_per_thread[ i ] += other_sim.work_per_thread[ i ];
+  }
 
   simulation_length.merge( other_sim.simulation_length );
   total_dmg.merge( other_sim.total_dmg );
@@ -3186,6 +3564,9 @@ void sim_t::merge( sim_t& other_sim )
     }
   }
 
+  // Statically created actors only touch their own collected data when merging, so they can be
+  // merged concurrently
+  std::vector<std::pair<player_t*, player_t*>> players;
   for ( auto & player : actor_list )
   {
     // If the player is spawned by a separate wrapper class, it will handle the merging process
@@ -3196,9 +3577,26 @@ void sim_t::merge( sim_t& other_sim )
 
     player_t* other_p = other_sim.find_player( player -> index );
     assert( other_p );
-    player -> merge( *other_p );
+    players.emplace_back( player, other_p );
   }
 
+  // Actors merged concurrently must not touch the error list. Their errors are collected per actor
+  // and reported in actor order once all actors are merged.
+  std::vector<std::vector<std::string>> actor_errors( players.size() );
+  parallel_for( thread_pool, n_workers, players.size(), [ &players, &actor_errors ]( size_t i ) {
+    merge_errors = &actor_errors[ i ];
+    auto reset_merge_errors = gsl::finally( [] { merge_errors = nullptr; } );
+    players[ i ].first -> merge( *players[ i ].second );
+  } );
+
+  // Errors of merges into a child sim are passed on to the main thread sim with the child's error
+  // list
+  for ( auto& errors : actor_errors )
+  {
+    range::for_each( errors, [ this ]( std::string& error ) { set_error( std::move( error ) ); } );
+  }
+  range::append( error_list, other_sim.error_list );
+
   raid_event_t::merge( this, &other_sim );
 
   // After normal player merging, merge all dynamically spawned players. This is done after the
@@ -3207,8 +3605,19 @@ void sim_t::merge( sim_t& other_sim )
   // than the parent
   spawner::merge( *this, other_sim );
 
-  range::append( iteration_data, other_sim.iteration_data );
-  merge_time += chrono::elapsed(start_time);
+  // The extremes of all threads are among the extremes of each thread
+  for ( const auto* heap : { &other_sim.low_iteration_data, &other_sim.high_iteration_data } )
+  {
+    for ( const auto& entry : *heap )
+    {
+      if ( ! iteration_data_seeds.count( entry.seed ) )
+      {
+        add_iteration_data( entry );
+      }
+    }
+  }
+  iteration_data_count += other_sim.iteration_data_count;
+  range::append( paired_seeds, other_sim.paired_seeds );
 }
 
 /// merge all sims together
@@ -3219,19 +3628,52 @@ void sim_t::merge()
   if ( children.empty() )
     return;
 
-  merge_mutex.unlock();
-
   for ( auto& child : children )
   {
     if ( child )
     {
       child -> join();
-      sim_t* copy = child;
-      child = nullptr;
-      if ( requires_cleanup() )
-      {
-        delete copy;
-      }
+      spinup_time = std::max( spinup_time, child -> spinup_time );
+    }
+  }
+
+  const auto start_time = chrono::wall_clock::now();
+
+  // Pairwise tree merge of all successfully finished sims. Each round merges sims[ i + stride ] into
+  // sims[ i ] for every i that is a multiple of 2 * stride, concurrently. Threads not needed for
+  // pairwise merging help merge the actors within a pair.
+  std::vector<sim_t*> sims { this };
+  range::copy_if( children, std::back_inserter( sims ), []( const sim_t* child ) {
+    return child && child -> iterate_succeeded;
+  } );
+
+  for ( size_t stride = 1; stride < sims.size(); stride *= 2 )
+  {
+    const auto round_start_time = chrono::wall_clock::now();
+
+    std::vector<std::pair<sim_t*, sim_t*>> pairs;
+    for ( size_t i = 0; i + stride < sims.size(); i += 2 * stride )
+    {
+      pairs.emplace_back( sims[ i ], sims[ i + stride ] );
+    }
+
+    size_t n_workers = std::max( size_t( 1 ), as<size_t>( threads ) / pairs.size() );
+    parallel_for( thread_pool, pairs.size(), pairs.size(), [ &pairs, n_workers ]( size_t i ) {
+      pairs[ i ].first -> merge( *pairs[ i ].second, n_workers );
+    } );
+
+    merge_round_time.push_back( chrono::elapsed( round_start_time ) );
+  }
+
+  merge_time += chrono::elapsed( start_time );
+
+  for ( auto& child : children )
+  {
+    sim_t* copy = child;
+    child = nullptr;
+    if ( copy && requires_cleanup() )
+    {
+      delete copy;
     }
   }
 
@@ -3244,9 +3686,10 @@ void sim_t::run()
 {
   try
   {
-    if( iterate() )
+    iterate_succeeded = iterate();
+    if ( iterate_succeeded )
     {
-      parent -> merge( *this );
+      work_per_thread[ thread_index ] = work_done;
     }
   }
   catch (const std::exception& e )
@@ -3263,6 +3706,17 @@ void sim_t::partition()
 {
   iterations = work_queue -> size();
 
+  // Every thread keeps enough extreme iterations to fill the report from its own, sized for the
+  // total work of all work queues (of all actors, in single actor batch mode). Work queues never grow
+  // past their initial size, target_error and flushing only end them early, so the iteration data
+  // heaps never need more entries.
+  auto total_work = []( const work_queue_t& queue ) {
+    size_t n = 0;
+    range::for_each( queue._total_work, [ &n ]( const std::atomic<int>& w ) { n += as<size_t>( w.load() ); } );
+    return n;
+  };
+  iteration_data_capacity = iteration_data_entries( total_work( *work_queue ) );
+
   if ( threads <= 1 )
     return;
   if ( iterations < threads )
@@ -3270,7 +3724,7 @@ void sim_t::partition()
 
   thread::set_main_thread_priority();
 
-  merge_mutex.lock(); // parent sim is locked until parent merge() is called
+  partition_start_time = chrono::wall_clock::now();
 
   int remainder = iterations % threads;
   iterations /= threads;
@@ -3279,7 +3733,7 @@ void sim_t::partition()
   // However, when we desire deterministic runs (for debugging) we need to force the
   // sims to each use a specific number of iterations as opposed to using shared pool of work.
 
-  if ( deterministic || strict_work_queue )
+  if ( work_queue_is_strict() )
   {
     work_queue -> init( iterations );
   }
@@ -3299,10 +3753,29 @@ void sim_t::partition()
     child_control = control;
   }
 
-  for ( int i = 0; i < num_children; i++ )
+  // Child setup (option parsing, actor creation) is independent for each child, so construct them
+  // concurrently instead of serially on the main thread.
+  std::vector<sim_t*> new_children( num_children, nullptr );
+  try
+  {
+    parallel_for( thread_pool, num_children, num_children, [ this, child_control, &new_children ]( size_t i ) {
+      new_children[ i ] = new sim_t( this, as<int>( i ) + 1, child_control );
+    } );
+  }
+  catch ( ... )
   {
-    auto  child = new sim_t( this, i + 1, child_control );
+    // Hand successfully created children over for normal cleanup
+    range::copy_if( new_children, std::back_inserter( children ), []( const sim_t* c ) { return c != nullptr; } );
+    throw;
+  }
 
+  // Replayed baseline seeds are handed out in thread order, thread 0 simulates the first ones. Every
+  // thread collects all but its first iteration (unless it only has one).
+  auto collected_iterations = []( int n ) { return as<size_t>( n > 1 ? n - 1 : n ); };
+  size_t paired_child_offset = paired_offset + collected_iterations( iterations );
+
+  for ( auto child : new_children )
+  {
     assert( child );
     children.push_back( child );
 
@@ -3313,7 +3786,10 @@ void sim_t::partition()
       remainder--;
     }
 
-    if( deterministic || strict_work_queue )
+    child -> paired_offset = paired_child_offset;
+    paired_child_offset += collected_iterations( child -> iterations );
+
+    if( work_queue_is_strict() )
     {
       child -> work_queue -> init( child -> iterations );
     }
@@ -3324,10 +3800,19 @@ void sim_t::partition()
     child -> report_progress = 0;
   }
 
+  // Strict work queues split the work between the threads, with the remainder going to the children
+  if ( work_queue_is_strict() )
+  {
+    size_t n = total_work( *work_queue );
+    range::for_each( children, [ &n, &total_work ]( const sim_t* child ) { n += total_work( *child -> work_queue ); } );
+    iteration_data_capacity = iteration_data_entries( n );
+  }
+  range::for_each( children, [ this ]( sim_t* child ) { child -> iteration_data_capacity = iteration_data_capacity; } );
+
   computer_process::set_priority( process_priority ); // Set main thread priority
 
   for ( auto & child : children )
-    child -> launch();
+    child -> launch( thread_pool );
 
   // Safe to do for now, since control is only referenced by sim_t::setup, which is called in the
   // sim_t constructor.
@@ -3360,6 +3845,48 @@ bool sim_t::execute()
   return success;
 }
 
+// sim_t::execute_delta_sims ================================================
+
+// Create, execute and consume n independent sims (scale factor, plot and reforge plot deltas).
+// Sims are created and consumed in order on the calling thread, and up to concurrent_delta_sims of
+// them execute at once on the thread pool. Without a thread pool they execute one after another.
+// create may return nullptr for an entry that needs no sim, consume takes ownership of the sim.
+void sim_t::execute_delta_sims( size_t n, const std::function<sim_t*( size_t )>& create,
+                                const std::function<void( size_t, sim_t* )>& consume )
+{
+  size_t window = thread_pool ? as<size_t>( concurrent_delta_sims ) : 1;
+  std::vector<sim_t*> sims;
+
+  for ( size_t first = 0; first < n && ! is_canceled(); first += window )
+  {
+    size_t last = std::min( n, first + window );
+
+    sims.clear();
+    for ( size_t i = first; i < last; ++i )
+    {
+      sim_t* s = create( i );
+      // Progress bars of concurrently executing sims would overwrite each other
+      if ( s && range::any_of( sims, []( const sim_t* other ) { return other != nullptr; } ) )
+      {
+        s -> report_progress = 0;
+      }
+      sims.push_back( s );
+    }
+
+    parallel_for( thread_pool, sims.size(), sims.size(), [ &sims ]( size_t i ) {
+      if ( sims[ i ] )
+      {
+        sims[ i ] -> execute();
+      }
+    } );
+
+    for ( size_t i = first; i < last; ++i )
+    {
+      consume( i, sims[ i - first ] );
+    }
+  }
+}
+
 /// find player in sim by name
 player_t* sim_t::find_player( util::string_view name ) const
 {
@@ -3667,6 +4194,8 @@ void sim_t::create_options()
   add_option( opt_float( "vary_combat_length", vary_combat_length, 0.0, 1.0 ) );
   add_option( opt_func( "ptr", parse_ptr ) );
   add_option( opt_int( "threads", threads ) );
+  add_option( opt_bool( "thread_pinning", thread_pinning ) );
+  add_option( opt_int( "concurrent_delta_sims", concurrent_delta_sims, 1, 64 ) );
   add_option( opt_float( "confidence", confidence, 0.0, 1.0 ) );
   add_option( opt_func( "spell_query", parse_spell_query ) );
   add_option( opt_string( "spell_query_xml_output_file", spell_query_xml_output_file_str ) );
@@ -3676,6 +4205,12 @@ void sim_t::create_options()
   add_option( opt_int( "max_aoe_enemies", max_aoe_enemies ) );
   add_option( opt_int( "optimize_expressions", optimize_expressions, 0, std::numeric_limits<int>::max() ) );
   add_option( opt_int( "optimize_expressions_rounds", optimize_expressions_rounds, 0, 100 ) );
+  add_option( opt_bool( "compile_expressions", compile_expressions ) );
+  add_option( opt_bool( "precombat_decision_cache", precombat_decision_cache ) );
+  add_option( opt_bool( "apl_profile", apl_profile ) );
+  add_option( opt_bool( "apl_readiness_index", apl_readiness_index ) );
+  add_option( opt_bool( "memoize_expressions", memoize_expressions ) );
+  add_option( opt_int( "apl_profile_sample_rate", apl_profile_sample_rate, 1, std::numeric_limits<int>::max() ) );
   add_option( opt_bool( "single_actor_batch", single_actor_batch ) );
   add_option( opt_bool( "progressbar_type", progressbar_type ) );
   add_option( opt_bool( "allow_experimental_specializations", allow_experimental_specializations ) );
@@ -3737,6 +4272,7 @@ void sim_t::create_options()
   add_option( opt_bool( "save_gear_comments", save_gear_comments ) );
   add_option( opt_bool( "buff_uptime_timeline", buff_uptime_timeline ) );
   add_option( opt_bool( "buff_stack_uptime_timeline", buff_stack_uptime_timeline ) );
+  add_option( opt_float( "timeline_bin_size", timeline_bin_size, 0.1, 60.0 ) );
   // Bloodlust
   add_option( opt_int( "bloodlust_percent", bloodlust_percent ) );
   add_option( opt_timespan( "bloodlust_time", bloodlust_time ) );
@@ -3751,10 +4287,14 @@ void sim_t::create_options()
   // RNG
   add_option( opt_bool( "deterministic", deterministic ) );
   add_option( opt_bool( "strict_work_queue", strict_work_queue ) );
+  add_option( opt_bool( "counter_rng", counter_rng ) );
+  add_option( opt_uint64( "counter_rng_iteration", counter_rng_iteration ) );
   add_option( opt_float( "report_iteration_data", report_iteration_data ) );
   add_option( opt_int( "min_report_iteration_data", min_report_iteration_data ) );
   add_option( opt_bool( "average_range", average_range ) );
   add_option( opt_bool( "average_gauss", average_gauss ) );
+  add_option( opt_bool( "rng_ziggurat", rng_ziggurat ) );
+  add_option( opt_bool( "rng_batch", rng_batch ) );
   // Misc
   add_option( opt_list( "party", party_encoding ) );
   add_option( opt_func( "active", parse_active ) );
@@ -3762,6 +4302,7 @@ void sim_t::create_options()
   add_option( opt_float( "wheel_granularity", event_mgr.wheel_granularity ) );
   add_option( opt_int( "wheel_seconds", event_mgr.wheel_seconds ) );
   add_option( opt_int( "wheel_shift", event_mgr.wheel_shift ) );
+  add_option( opt_func( "event_queue", parse_event_queue ) );
   add_option( opt_string( "reference_player", reference_player_str ) );
   add_option( opt_string( "raid_events", raid_events_str ) );
   add_option( opt_append( "raid_events+", raid_events_str ) );
@@ -3851,6 +4392,8 @@ void sim_t::create_options()
   add_option( opt_bool( "report_raw_abilities", report_raw_abilities ) );
   add_option( opt_bool( "report_rng", report_rng ) );
   add_option( opt_int( "statistics_level", statistics_level ) );
+  add_option( opt_func( "data_collection", parse_data_collection ) );
+  add_option( opt_float( "statistics_sketch", statistics_sketch, 0, 10000 ) );
   add_option( opt_bool( "separate_stats_by_actions", separate_stats_by_actions ) );
   add_option( opt_bool( "report_raid_summary", report_raid_summary ) ); // Force reporting of raid summary
   add_option( opt_string( "reforge_plot_output_file", reforge_plot_output_file_str ) );
@@ -4283,15 +4826,19 @@ void sim_t::setup( sim_control_t* c )
     }
   }
 
+  // Iteration pairing needs a baseline with profilesets to pair with
+  if ( ! parent && ( profileset_map.empty() || single_actor_batch ) )
+  {
+    profileset_paired = false;
+  }
+
   if ( single_actor_batch )
   {
     work_queue -> batches( player_no_pet_list.size() );
   }
   work_queue -> init( iterations );
-  if ( thread_index == 0 )
-  {
-    work_per_thread.resize( threads );
-  }
+  // Every thread keeps per-thread work counts, so they can be merged in any order
+  work_per_thread.resize( threads );
 
   if( deterministic && ( target_error != 0 ) )
   {
@@ -4313,7 +4860,7 @@ sim_progress_t sim_t::progress( std::string* detailed, int index )
   }
 
   // For work queues that are independent, collect all work done so far for the progressbar.
-  if ( deterministic || strict_work_queue )
+  if ( work_queue_is_strict() )
   {
     AUTO_LOCK( relatives_mutex );
     for ( const auto& child : children )
@@ -4442,6 +4989,10 @@ std::vector<double> sc_timeline_t::build_divisor_timeline( const extended_sample
   size_t max_buckets = static_cast<size_t>( floor( simulation_length.max() / bin_size ) + 1);
   divisor_timeline.assign( max_buckets, 0.0 );
 
+  // Number of iterations whose visited buckets end at each bucket. Every bucket up to and including
+  // the end bucket is visited, so the divisor is the suffix sum of the end counts.
+  std::vector<double> ends( max_buckets, 0.0 );
+
   size_t num_timelines = simulation_length.data().size();
   for ( size_t i = 0; i < num_timelines; i++ )
   {
@@ -4452,29 +5003,32 @@ std::vector<double> sc_timeline_t::build_divisor_timeline( const extended_sample
     if ( use_old_behaviour )
     {
       // Add all visited buckets.
-      for ( size_t j = 0; j <= last; j++ )
-      {
-        divisor_timeline[ j ] += 1.0;
-      }
+      ends[ last ] += 1.0;
     }
     else
     {
       // First add fully visited buckets.
-      for ( size_t j = 0; j < last; j++ )
+      if ( last > 0 )
       {
-        divisor_timeline[ j ] += 1.0;
+        ends[ last - 1 ] += 1.0;
       }
 
       // Now add partial amount for the last incomplete bucket.
       double remainder = simulation_length.data()[ i ] / bin_size - last;
       if ( remainder > 0.0 )
       {
-        assert( last < divisor_timeline.size() );
         divisor_timeline[ last ] += remainder;
       }
     }
   }
 
+  double visits = 0;
+  for ( size_t j = max_buckets; j-- > 0; )
+  {
+    visits += ends[ j ];
+    divisor_timeline[ j ] += visits;
+  }
+
   return divisor_timeline;
 }
 
@@ -4483,16 +5037,23 @@ std::vector<double> sc_timeline_t::build_divisor_timeline( const extended_sample
  */
 void sc_timeline_t::adjust( sim_t& sim )
 {
-  // Check if we have divisor timeline cached
-  auto it = sim.divisor_timeline_cache.find( bin_size_ );
-  if ( it == sim.divisor_timeline_cache.end() )
+  const std::vector<double>* divisor_timeline;
   {
-    // If we don't have a cached divisor timeline, build one
-    sim.divisor_timeline_cache[ bin_size_ ] = build_divisor_timeline( sim.simulation_length, bin_size_ );
+    AUTO_LOCK( sim.divisor_timeline_mutex );
+
+    // Check if we have divisor timeline cached
+    auto it = sim.divisor_timeline_cache.find( bin_size_ );
+    if ( it == sim.divisor_timeline_cache.end() )
+    {
+      // If we don't have a cached divisor timeline, build one
+      it = sim.divisor_timeline_cache.emplace( bin_size_, build_divisor_timeline( sim.simulation_length, bin_size_ ) ).first;
+    }
+
+    divisor_timeline = &it->second;
   }
 
   // Do the timeline adjustement
-  timeline_t::adjust( sim.divisor_timeline_cache[ bin_size_ ] );
+  timeline_t::adjust( *divisor_timeline );
 }
 
 void sc_timeline_t::adjust( const extended_sample_data_t& adjustor )
@@ -4507,14 +5068,14 @@ void sim_t::enable_debug_seed()
 {
   auto enabled = false;
 
-  if ( debug_seed.size() == 1 && seed == debug_seed[ 0 ] )
+  if ( debug_seed.size() == 1 && iteration_seed == debug_seed[ 0 ] )
   {
     enabled = true;
   }
   else
   {
-    auto it = range::lower_bound( debug_seed, seed );
-    enabled = it != debug_seed.end() && *it == seed;
+    auto it = range::lower_bound( debug_seed, iteration_seed );
+    enabled = it != debug_seed.end() && *it == iteration_seed;
   }
 
   if ( enabled )
@@ -4526,7 +5087,7 @@ void sim_t::enable_debug_seed()
     }
 
     std::shared_ptr<io::ofstream> o(new io::ofstream());
-    std::string fname = output_file_str + "." + util::to_string( seed );
+    std::string fname = output_file_str + "." + util::to_string( iteration_seed );
     o -> open( fname );
     if ( o -> is_open() )
     {
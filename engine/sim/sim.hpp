@@ -17,8 +17,10 @@
 #include "util/util.hpp"
 #include "util/vector_with_callback.hpp"
 
+#include <array>
 #include <map>
 #include <memory>
+#include <unordered_set>
 
 struct actor_target_data_t;
 struct buff_t;
@@ -62,6 +64,9 @@ struct sim_t : private sc_thread_t
 {
   event_manager_t event_mgr;
 
+  // Change counters of the simulation state that memoized expressions depend on
+  std::array<uint64_t, static_cast<size_t>( state_generation::MAX )> state_generations;
+
   // Output
   sim_ostream_t out_log;
   sim_ostream_t out_debug;
@@ -80,6 +85,8 @@ struct sim_t : private sc_thread_t
   // will force-enable the option)
   bool cleanup_threads;
   bool initialized;
+  // Child sim finished iterating successfully, and has results to merge
+  bool iterate_succeeded;
   bool fixed_time;
   bool save_profiles;
   bool save_profile_with_actions;  // When saving full profiles, include actions or not
@@ -128,6 +135,12 @@ struct sim_t : private sc_thread_t
   timespan_t  ignite_sampling_delta;
   int         optimize_expressions;
   int         optimize_expressions_rounds;
+  bool        compile_expressions;
+  bool        precombat_decision_cache;
+  bool        apl_profile;
+  bool        apl_readiness_index;
+  bool        memoize_expressions;
+  int         apl_profile_sample_rate;
   int         current_slot;
   int         optimal_raid, log, debug_each;
   std::vector<uint64_t> debug_seed;
@@ -197,7 +210,19 @@ struct sim_t : private sc_thread_t
   uint64_t seed;
   int deterministic;
   int strict_work_queue;
+  // Counter-based iteration seeds. Every iteration reseeds from ( counter_rng_key, iteration_key ),
+  // where the iteration key is the work queue ticket of the iteration, so results do not depend on
+  // the number of threads or on which thread simulates the iteration.
+  bool counter_rng;
+  uint64_t counter_rng_iteration; // Iteration key replayed by iterations=1 sims
+  uint64_t counter_rng_key; // Base seed of the counter-based iteration seeds
+  uint64_t iteration_key;
+  uint64_t iteration_seed; // Seed the current iteration was started from
   int average_range, average_gauss;
+  // Ziggurat sampling of normal and exponential distributions (rng::basic_rng_t::ziggurat)
+  bool rng_ziggurat;
+  // Batched xoshiro256+ engine (rng::xoshiro256plus_batch_t)
+  bool rng_batch;
 
   // Raid Events
   std::vector<std::unique_ptr<raid_event_t>> raid_events;
@@ -564,13 +589,32 @@ struct sim_t : private sc_thread_t
   simple_sample_data_t total_dmg, raid_hps, total_heal, total_absorb, raid_aps;
   extended_sample_data_t raid_dps, simulation_length;
   chrono::wall_clock::duration merge_time, init_time, analyze_time;
+  // Wall clock time of each pairwise merge round of child sims
+  std::vector<chrono::wall_clock::duration> merge_round_time;
+  // Wall clock time from partitioning until the slowest child sim was ready to iterate
+  chrono::wall_clock::duration spinup_time;
+  chrono::wall_clock::time_point partition_start_time;
   // Deterministic simulation iteration data collectors for specific iteration
-  // replayability
+  // replayability. While iterating, low/high_iteration_data are bounded heaps of the
+  // iteration_data_capacity lowest/highest entries of the thread; analyze_iteration_data turns them
+  // into the sorted report tables.
   std::vector<iteration_data_entry_t> iteration_data, low_iteration_data, high_iteration_data;
   // Report percent (how many% of lowest/highest iterations reported, default 2.5%)
   double     report_iteration_data;
   // Minimum number of low/high iterations reported (default 5 of each)
   int        min_report_iteration_data;
+  // Seeds of the entries held in the heaps, one instance per heap holding the entry
+  std::unordered_multiset<uint64_t> iteration_data_seeds;
+  size_t     iteration_data_count;
+  size_t     iteration_data_capacity;
+  // Common random numbers for profilesets. Paired sims reseed every iteration and record the seeds of
+  // collected iterations in iteration order. Profileset sims replay the seeds of the baseline in their
+  // collected iterations, starting from paired_offset.
+  bool       profileset_paired;
+  std::vector<uint64_t> paired_seeds;
+  const std::vector<uint64_t>* paired_baseline;
+  size_t     paired_offset;
+  bool       paired_replay; // Current iteration replays a baseline seed
   int        report_progress;
   int        bloodlust_percent;
   timespan_t bloodlust_time;
@@ -586,6 +630,7 @@ struct sim_t : private sc_thread_t
   std::vector<player_t*> targets_by_name;
   std::vector<std::string> id_dictionary;
   std::map<double, std::vector<double> > divisor_timeline_cache;
+  mutex_t divisor_timeline_mutex; // Actor data is analyzed in parallel
   std::vector<report::json::report_configuration_t> json_reports;
   std::string output_file_str, html_file_str, json_file_str;
   std::string reforge_plot_output_file_str;
@@ -601,10 +646,13 @@ struct sim_t : private sc_thread_t
   int save_raid_summary;
   int save_gear_comments;
   int statistics_level;
+  data_collection_level data_collection;
+  double statistics_sketch; // Quantile sketch compression for per-iteration samples, 0 saves all samples
   int separate_stats_by_actions;
   int report_raid_summary;
   int buff_uptime_timeline;
   int buff_stack_uptime_timeline;
+  double timeline_bin_size; // Bin width in seconds of actor and ability timelines
   bool json_full_states;
   int decorated_tooltips;
 
@@ -625,6 +673,9 @@ struct sim_t : private sc_thread_t
   // Multi-Threading
   mutex_t merge_mutex;
   int threads;
+  bool thread_pinning;
+  thread_pool_t* thread_pool; // Owned by sim_t::main, shared by all sims of the invocation
+  int concurrent_delta_sims; // Scale factor, plot and reforge plot sims executing at once
   std::vector<sim_t*> children; // Manual delete!
   int thread_index;
   computer_process::priority_e process_priority;
@@ -677,6 +728,16 @@ struct sim_t : private sc_thread_t
   std::vector<std::string> profileset_output_data;
   bool profileset_enabled;
   int profileset_work_threads, profileset_init_threads;
+  // Profileset racing: iterations of the first round, and the iteration growth between rounds
+  bool profileset_racing;
+  int profileset_racing_iterations;
+  double profileset_racing_growth;
+  // Profileset sharding: simulate shard profileset_shard_index (zero-based) out of
+  // profileset_shard_count, and write the results to profileset_shard_output ("-" for stdout).
+  // profileset_merge lists shard result files ("-" for stdin) to report instead of simulating.
+  unsigned profileset_shard_index, profileset_shard_count;
+  std::string profileset_shard_output;
+  opts::list_t profileset_merge;
   std::unique_ptr<profileset::profilesets_t> profilesets;
 
 
@@ -690,6 +751,7 @@ struct sim_t : private sc_thread_t
   double    iteration_time_adjust();
   double    expected_max_time() const;
   bool      is_canceled() const;
+  bool      work_queue_is_strict() const;
   void      cancel_iteration();
   void      cancel();
   void      interrupt();
@@ -709,13 +771,17 @@ struct sim_t : private sc_thread_t
   void      init_actor_pets();
   void      init();
   void      analyze();
-  void      merge( sim_t& other_sim );
+  void      merge( sim_t& other_sim, size_t n_workers = 1 );
   void      merge();
   bool      iterate();
   void      partition();
   bool      execute();
+  void      execute_delta_sims( size_t n, const std::function<sim_t*( size_t )>& create,
+                                const std::function<void( size_t, sim_t* )>& consume );
   void      analyze_error();
   void      analyze_iteration_data();
+  size_t    iteration_data_entries( size_t n ) const;
+  void      add_iteration_data( const iteration_data_entry_t& entry );
   void      print_options();
   void      add_option( std::unique_ptr<option_t> opt );
   void      create_options();
@@ -733,7 +799,7 @@ struct sim_t : private sc_thread_t
   template <typename... Args>
   void errorf( util::string_view format, Args&&... args )
   {
-    if ( thread_index != 0 )
+    if ( thread_index != 0 && ! merge_errors )
       return;
 
     set_error( fmt::sprintf( format, std::forward<Args>(args)... ) );
@@ -745,7 +811,7 @@ struct sim_t : private sc_thread_t
   template <typename... Args>
   void error( fmt::format_string<Args...> format, Args&&... args )
   {
-    if ( thread_index != 0 )
+    if ( thread_index != 0 && ! merge_errors )
       return;
 
     set_error( fmt::vformat( format, fmt::make_format_args( args... ) ) );
@@ -767,8 +833,15 @@ struct sim_t : private sc_thread_t
 
   timespan_t current_time() const
   { return event_mgr.current_time; }
+  // State generations are only read by memoized expressions
+  void bump_state_generation( state_generation s )
+  { if ( memoize_expressions ) ++state_generations[ static_cast<size_t>( s ) ]; }
+  void bump_state_generation()
+  { if ( memoize_expressions ) for ( auto& g : state_generations ) ++g; }
   static double distribution_mean_error( const sim_t& s, const extended_sample_data_t& sd )
   { return s.confidence_estimator * sd.mean_std_dev; }
+  static double distribution_mean_error( const sim_t& s, const running_moments_t& m )
+  { return s.confidence_estimator * m.mean_std_dev(); }
   void register_target_data_initializer(std::function<void(actor_target_data_t*)> cb)
   { target_data_initializer.push_back( cb ); }
   const rng::rng_t& rng() const
@@ -821,6 +894,9 @@ struct sim_t : private sc_thread_t
   }
 
 private:
+  // Errors of the actor being merged on this thread, see sim_t::merge
+  static thread_local std::vector<std::string>* merge_errors;
+
   void set_error(std::string error);
   void do_pause();
   void print_spell_query();
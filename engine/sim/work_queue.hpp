@@ -5,84 +5,178 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <vector>
-#include <mutex>
 #include "util/generic.hpp"
 
 struct sim_progress_t;
 
+// Lock-free iteration dispenser. The queue hands out iteration "tickets", one per finished
+// iteration. Threads claim tickets in batches with a compare-and-swap on the shared counter, and
+// consume them locally until the batch runs out or the queue is flushed. Batches shrink as the
+// queue nears its end, so threads still finish at roughly the same time. Claimed tickets run ahead
+// of finished iterations, progress is reported from a separate count of consumed tickets.
 struct work_queue_t
   {
-    private:
-#ifndef SC_NO_THREADING
-    std::recursive_mutex m;
-    using G = std::lock_guard<std::recursive_mutex>;
-#else
-    struct no_m {
-      void lock() {}
-      void unlock() {}
-    };
-    struct nop {
-      nop(no_m i) { (void)i; }
+    // Per-thread claim state, owned by the iterating sim
+    struct batch_t
+    {
+      size_t   index     = 0;    // Work index the batch was claimed from
+      int      next      = 0;    // Next unconsumed ticket of the batch
+      int      end       = 0;    // One past the last ticket of the batch
+      unsigned epoch     = 0;    // Flush epoch at the time of the claim
+      bool     more      = true; // Result of the latest pop()
+      int      ticket    = -1;   // Ticket of the latest pop(), -1 if none was consumed
     };
-    no_m m;
-    using G = nop;
-#endif
-    public:
-    std::vector<int> _total_work, _work, _projected_work;
-    size_t index;
 
-    work_queue_t() : index( 0 )
-    { _total_work.resize( 1 ); _work.resize( 1 ); _projected_work.resize( 1 ); }
+    static constexpr int MAX_BATCH = 16;
+    static constexpr int BATCH_DIVISOR = 256;
 
-    void init( int w )    { G l(m); range::fill( _total_work, w ); range::fill( _projected_work, w ); }
-    // Single actor batch sim init methods. Batches is the number of active actors
-    void batches( size_t n ) { G l(m); _total_work.resize( n ); _work.resize( n ); _projected_work.resize( n ); }
+    private:
+    using counter_t = std::vector<std::atomic<int>>;
 
-    void flush()          { G l(m); _total_work[ index ] = _projected_work[ index ] = _work[ index ]; }
-    int  size()           { G l(m); return index < _total_work.size() ? _total_work[ index ] : _total_work.back(); }
-    bool more_work()      { G l(m); return index < _total_work.size() && _work[ index ] < _total_work[ index ]; }
-    void lock()           { m.lock(); }
-    void unlock()         { m.unlock(); }
+    std::atomic<unsigned> epoch;
 
-    void project( int w )
+    static void assign( counter_t& c, size_t n, int v )
     {
-      G l(m);
-      _projected_work[ index ] = w;
-#ifdef NDEBUG
-      if ( w > _work[ index ] )
+      c = counter_t( n );
+      for ( auto& e : c ) e.store( v, std::memory_order_relaxed );
+    }
+
+    // Batch size for the given amount of unclaimed work
+    static int batch_size( int remaining )
+    { return std::max( 1, std::min( MAX_BATCH, remaining / BATCH_DIVISOR ) ); }
+
+    // Move the shared index past an exhausted work index. Returns the current index.
+    size_t advance( size_t idx )
+    {
+      if ( idx < _work.size() - 1 )
       {
+        index.compare_exchange_strong( idx, idx + 1, std::memory_order_acq_rel );
       }
-#endif
+      return index.load( std::memory_order_acquire );
     }
 
-    // Single-actor batch pop, uses several indices of work (per active actor), each thread has it's
-    // own state on what index it is simulating
-    size_t pop()
+    public:
+    counter_t _total_work, _work, _done_work, _projected_work;
+    std::atomic<size_t> index;
+
+    work_queue_t() : epoch( 0 ), index( 0 )
     {
-      G l(m);
+      assign( _total_work, 1, 0 ); assign( _work, 1, 0 ); assign( _done_work, 1, 0 );
+      assign( _projected_work, 1, 0 );
+    }
+
+    void init( int w )
+    {
+      for ( auto& e : _total_work ) e.store( w );
+      for ( auto& e : _projected_work ) e.store( w );
+    }
 
-      if ( _work[ index ] >= _total_work[ index ] )
+    // Single actor batch sim init methods. Batches is the number of active actors. Must be called
+    // before any thread starts iterating.
+    void batches( size_t n )
+    {
+      assign( _total_work, n, 0 ); assign( _work, n, 0 ); assign( _done_work, n, 0 );
+      assign( _projected_work, n, 0 );
+    }
+
+    // Stop handing out work, outstanding batches are invalidated
+    void flush()
+    {
+      size_t idx = index.load();
+      int w = std::min( _done_work[ idx ].load(), _total_work[ idx ].load() );
+      _total_work[ idx ] = w;
+      _projected_work[ idx ] = w;
+      epoch.fetch_add( 1, std::memory_order_release );
+    }
+
+    int size() const
+    {
+      size_t idx = index.load( std::memory_order_relaxed );
+      return idx < _total_work.size() ? _total_work[ idx ].load() : _total_work.back().load();
+    }
+
+    bool more_work( const batch_t& batch ) const
+    { return batch.more; }
+
+    void project( int w )
+    { _projected_work[ index.load( std::memory_order_relaxed ) ].store( w, std::memory_order_relaxed ); }
+
+    // Record a finished iteration, and determine the work index to simulate next. Single-actor
+    // batch sims use several indices of work (per active actor), the shared index moves on to the
+    // next actor once all work of the current one has been handed out.
+    size_t pop( batch_t& batch )
+    {
+      // Serve from the thread's own batch, unless the queue has been flushed since the claim. The
+      // batch is finished even if the shared index has moved on, so every index receives all of its
+      // work.
+      if ( batch.next < batch.end && batch.epoch == epoch.load( std::memory_order_acquire ) )
       {
-        if ( index < _work.size() - 1 )
-        {
-          ++index;
-        }
-        return index;
+        return consume( batch );
       }
 
-      if ( ++_work[ index ] == _total_work[ index ] )
+      size_t idx = index.load( std::memory_order_acquire );
+      unsigned e = epoch.load( std::memory_order_acquire );
+      int w      = _work[ idx ].load( std::memory_order_relaxed );
+      int total  = _total_work[ idx ].load( std::memory_order_relaxed );
+      while ( w < total )
       {
-        _projected_work[ index ] = _work[ index ];
-        if ( index < _work.size() - 1 )
+        int n = batch_size( total - w );
+        if ( _work[ idx ].compare_exchange_weak( w, w + n, std::memory_order_acq_rel ) )
         {
-          ++index;
+          batch.index = idx;
+          batch.next  = w;
+          batch.end   = w + n;
+          batch.epoch = e;
+          return consume( batch );
         }
-        return index;
+        total = _total_work[ idx ].load( std::memory_order_relaxed );
+      }
+
+      // All work of this index has been handed out
+      batch.next = batch.end = 0;
+      batch.ticket = -1;
+      if ( idx >= _work.size() - 1 )
+      {
+        batch.more = false;
+        return idx;
       }
 
-      return index;
+      // Like the first iteration of a thread, the first iteration on a new index is not counted
+      idx = advance( idx );
+      batch.more = _work[ idx ].load() < _total_work[ idx ].load();
+      return idx;
     }
 
     sim_progress_t progress( int idx = -1 );
-  };
\ No newline at end of file
+
+    private:
+    size_t consume( batch_t& batch )
+    {
+      int ticket = batch.next++;
+      int total  = _total_work[ batch.index ].load( std::memory_order_relaxed );
+      batch.ticket = ticket;
+      _done_work[ batch.index ].fetch_add( 1, std::memory_order_relaxed );
+
+      if ( ticket + 1 < total )
+      {
+        batch.more = true;
+        return batch.index;
+      }
+
+      // Last ticket of this index
+      _projected_work[ batch.index ].store( total, std::memory_order_relaxed );
+      batch.next = batch.end = 0;
+      if ( batch.index < _work.size() - 1 )
+      {
+        size_t idx = advance( batch.index );
+        batch.more = _work[ idx ].load() < _total_work[ idx ].load();
+        return idx;
+      }
+
+      batch.more = false;
+      return batch.index;
+    }
+  };
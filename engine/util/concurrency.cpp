@@ -5,15 +5,22 @@
 
 #include "concurrency.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 #include <stdio.h>
 
 #if defined( SC_WINDOWS )
 #define NOMINMAX
 #include <windows.h>
+#elif defined( __linux__ ) && ! defined( SC_NO_THREADING )
+#include <pthread.h>
 #endif
 
 // C++11 STL multi-threading hook-ups
@@ -34,10 +41,177 @@ public:
   { m.unlock(); }
 };
 
+class thread_pool_t::task_t
+{
+  enum state_e { PENDING, RUNNING, DONE };
+
+  std::function<void()> fn;
+  std::atomic<int> state;
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable done;
+
+public:
+  task_t( std::function<void()> f ) :
+    fn( std::move( f ) ), state( PENDING ), error(), mutex(), done()
+  { }
+
+  // Claim the task for execution. Only the first claim succeeds.
+  bool claim()
+  {
+    int expected = PENDING;
+    return state.compare_exchange_strong( expected, RUNNING );
+  }
+
+  void execute()
+  {
+    try
+    {
+      fn();
+    }
+    catch ( ... )
+    {
+      error = std::current_exception();
+    }
+    fn = nullptr;
+
+    std::lock_guard<std::mutex> lock( mutex );
+    state = DONE;
+    done.notify_all();
+  }
+
+  void wait()
+  {
+    std::unique_lock<std::mutex> lock( mutex );
+    done.wait( lock, [ this ] { return state == DONE; } );
+  }
+
+  void rethrow() const
+  {
+    if ( error )
+    {
+      std::rethrow_exception( error );
+    }
+  }
+};
+
+class thread_pool_t::native_t
+{
+private:
+  std::mutex mutex;
+  std::condition_variable work;
+  std::deque<task_ptr> queue;
+  std::vector<std::thread> threads;
+  bool shutdown;
+
+  void worker()
+  {
+    while ( true )
+    {
+      task_ptr task;
+      {
+        std::unique_lock<std::mutex> lock( mutex );
+        work.wait( lock, [ this ] { return shutdown || ! queue.empty(); } );
+        // Pending work is drained before shutting down
+        if ( queue.empty() )
+        {
+          return;
+        }
+
+        task = std::move( queue.front() );
+        queue.pop_front();
+      }
+
+      // Tasks waited on before a worker got to them have already been run by the waiting thread
+      if ( task -> claim() )
+      {
+        task -> execute();
+      }
+    }
+  }
+
+  static void pin( std::thread& t, unsigned cpu )
+  {
+#if defined( SC_WINDOWS )
+    SetThreadAffinityMask( t.native_handle(), DWORD_PTR( 1 ) << ( cpu % ( sizeof( DWORD_PTR ) * 8 ) ) );
+#elif defined( __linux__ )
+    cpu_set_t cpu_set;
+    CPU_ZERO( &cpu_set );
+    CPU_SET( cpu % CPU_SETSIZE, &cpu_set );
+    pthread_setaffinity_np( t.native_handle(), sizeof( cpu_set ), &cpu_set );
+#else
+    ( void ) t;
+    ( void ) cpu;
+#endif
+  }
+
+public:
+  native_t( unsigned n_threads, bool pin_threads ) :
+    mutex(), work(), queue(), threads(), shutdown( false )
+  {
+    unsigned n_cpus = std::max( 1U, std::thread::hardware_concurrency() );
+    threads.reserve( n_threads );
+    for ( unsigned i = 0; i < n_threads; ++i )
+    {
+      threads.emplace_back( [ this ] { worker(); } );
+      if ( pin_threads )
+      {
+        pin( threads.back(), i % n_cpus );
+      }
+    }
+  }
+
+  ~native_t()
+  {
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      shutdown = true;
+    }
+    work.notify_all();
+
+    for ( auto& t : threads )
+    {
+      t.join();
+    }
+  }
+
+  unsigned size() const
+  { return static_cast<unsigned>( threads.size() ); }
+
+  task_ptr submit( std::function<void()> fn )
+  {
+    auto task = std::make_shared<task_t>( std::move( fn ) );
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      queue.push_back( task );
+    }
+    work.notify_one();
+
+    return task;
+  }
+
+  static void wait( const task_ptr& task )
+  {
+    if ( task -> claim() )
+    {
+      task -> execute();
+    }
+    else
+    {
+      task -> wait();
+    }
+
+    task -> rethrow();
+  }
+};
+
 class sc_thread_t::native_t
 {
 private:
   std::unique_ptr<std::thread> t;
+  thread_pool_t* pool;
+  thread_pool_t::task_ptr task;
+  std::thread::id task_thread_id;
 
   static void execute( sc_thread_t* t )
   {
@@ -45,18 +219,33 @@ private:
   }
 public:
   native_t() :
-  t()
+  t(), pool( nullptr ), task(), task_thread_id()
   { }
 
   std::thread::id id() const
-  { return t -> get_id(); }
+  { return t ? t -> get_id() : task_thread_id; }
 
-  void launch( sc_thread_t* thr)
+  void launch( sc_thread_t* thr, thread_pool_t* p )
   {
-    t = std::make_unique<std::thread>( &sc_thread_t::native_t::execute, thr );
+    if ( p )
+    {
+      pool = p;
+      task = pool -> submit( [ this, thr ] {
+        task_thread_id = std::this_thread::get_id();
+        execute( thr );
+      } );
+    }
+    else
+    {
+      t = std::make_unique<std::thread>( &sc_thread_t::native_t::execute, thr );
+    }
   }
 
   void join() {
+    if ( task ) {
+      pool -> wait( task );
+      task = nullptr;
+    }
     if ( t && t -> joinable() ) {
       t -> join();
     }
@@ -87,6 +276,25 @@ void mutex_t::lock()
 void mutex_t::unlock()
 { native_handle -> unlock(); }
 
+thread_pool_t::thread_pool_t( unsigned n_threads, bool pin_threads ) :
+  native_handle( new native_t( n_threads, pin_threads ) )
+{}
+
+thread_pool_t::~thread_pool_t() = default;
+
+unsigned thread_pool_t::size() const
+{ return native_handle -> size(); }
+
+// thread_pool_t::submit() ==================================================
+
+thread_pool_t::task_ptr thread_pool_t::submit( std::function<void()> fn )
+{ return native_handle -> submit( std::move( fn ) ); }
+
+// thread_pool_t::wait() ====================================================
+
+void thread_pool_t::wait( const task_ptr& task )
+{ native_t::wait( task ); }
+
 sc_thread_t::sc_thread_t() : native_handle( new native_t() )
 {}
 
@@ -94,8 +302,8 @@ sc_thread_t::~sc_thread_t() = default;
 
 // sc_thread_t::launch() ====================================================
 
-void sc_thread_t::launch()
-{ native_handle -> launch( this ); }
+void sc_thread_t::launch( thread_pool_t* pool )
+{ native_handle -> launch( this, pool ); }
 
 /**
  * @brief Wait for thread to finish its execution.
@@ -142,6 +350,17 @@ public:
   {}
 };
 
+// Without threading support, tasks are run as soon as they are submitted
+class thread_pool_t::task_t
+{
+public:
+  std::exception_ptr error;
+};
+
+class thread_pool_t::native_t
+{
+};
+
 class sc_thread_t::native_t
 {
 private:
@@ -152,7 +371,7 @@ private:
   }
 public:
 
-  void launch( sc_thread_t* thr)
+  void launch( sc_thread_t* thr, thread_pool_t* )
   {
     thr->run();
   }
@@ -191,10 +410,48 @@ sc_thread_t::~sc_thread_t()
   // Keep in .cpp file so that std::unique_ptr deleter can see defined native_t class
 }
 
+thread_pool_t::thread_pool_t( unsigned, bool ) : native_handle( new native_t() )
+{}
+
+thread_pool_t::~thread_pool_t()
+{
+  // Keep in .cpp file so that std::unique_ptr deleter can see defined native_t class
+}
+
+unsigned thread_pool_t::size() const
+{ return 0; }
+
+// thread_pool_t::submit() ==================================================
+
+thread_pool_t::task_ptr thread_pool_t::submit( std::function<void()> fn )
+{
+  auto task = std::make_shared<task_t>();
+  try
+  {
+    fn();
+  }
+  catch ( ... )
+  {
+    task -> error = std::current_exception();
+  }
+
+  return task;
+}
+
+// thread_pool_t::wait() ====================================================
+
+void thread_pool_t::wait( const task_ptr& task )
+{
+  if ( task -> error )
+  {
+    std::rethrow_exception( task -> error );
+  }
+}
+
 // sc_thread_t::launch() ====================================================
 
-void sc_thread_t::launch()
-{ native_handle -> launch( this ); }
+void sc_thread_t::launch( thread_pool_t* pool )
+{ native_handle -> launch( this, pool ); }
 
 /**
  * @brief Wait for thread to finish its execution.
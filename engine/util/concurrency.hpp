@@ -13,6 +13,7 @@
 
 #include "config.hpp"
 #include "util/generic.hpp"
+#include <functional>
 #include <memory>
 
 #ifndef SC_NO_THREADING
@@ -34,6 +35,31 @@ public:
   void unlock();
 };
 
+// Long-lived pool of worker threads, shared by everything that runs concurrently during a simulator
+// invocation (child sims, profileset workers, parallel merging). Tasks are started in submission
+// order. Waiting on a task that has not been started yet runs it on the waiting thread instead, so
+// tasks that wait on other tasks (e.g., a profileset sim joining its child sims) cannot starve the
+// pool.
+class thread_pool_t : private noncopyable
+{
+public:
+  class task_t;
+  using task_ptr = std::shared_ptr<task_t>;
+
+private:
+  class native_t;
+  std::unique_ptr<native_t> native_handle;
+
+public:
+  thread_pool_t( unsigned n_threads, bool pin_threads = false );
+  ~thread_pool_t();
+
+  unsigned size() const;
+  task_ptr submit( std::function<void()> fn );
+  // Wait for the task to finish, rethrowing any exception it threw
+  void wait( const task_ptr& task );
+};
+
 class sc_thread_t : private noncopyable
 {
 private:
@@ -47,7 +73,8 @@ public:
 #ifndef SC_NO_THREADING
   std::thread::id thread_id() const;
 #endif
-  void launch();
+  // Run on the given thread pool, or a dedicated thread if no pool is given
+  void launch( thread_pool_t* pool = nullptr );
   void join();
   static void sleep_seconds( double );
   static unsigned cpu_thread_count();
@@ -0,0 +1,240 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "config.hpp"
+#include "util/generic.hpp"
+
+/* Bounded-memory quantile sketch ( merging t-digest, Dunning & Ertl ).
+ *
+ * Samples are collected into a buffer, which is periodically folded into a sorted list of
+ * weighted centroids. Centroids near the tails of the distribution are kept small, so extreme
+ * quantiles stay accurate. The number of centroids is bounded by roughly the compression
+ * parameter, regardless of the number of samples added; the rank error of a quantile estimate
+ * is on the order of 1 / compression.
+ */
+class quantile_sketch_t
+{
+public:
+  using value_t = double;
+
+private:
+  struct centroid_t
+  {
+    value_t mean;
+    value_t weight;
+  };
+
+  double _compression;
+  value_t _min = std::numeric_limits<value_t>::max();
+  value_t _max = std::numeric_limits<value_t>::lowest();
+  value_t _weight = 0;
+  std::vector<centroid_t> _centroids;
+  std::vector<centroid_t> _buffer;
+
+  size_t buffer_limit() const
+  {
+    return std::max<size_t>( 32, static_cast<size_t>( 5 * _compression ) );
+  }
+
+  // k1 scale function, and its inverse
+  double scale( double q ) const
+  {
+    return _compression / ( 2 * m_pi ) * std::asin( 2 * q - 1 );
+  }
+
+  double scale_inverse( double k ) const
+  {
+    return ( std::sin( std::min( k * ( 2 * m_pi ) / _compression, m_pi / 2 ) ) + 1 ) / 2;
+  }
+
+public:
+  explicit quantile_sketch_t( double compression = 100.0 ) : _compression( compression )
+  {
+  }
+
+  double compression() const
+  {
+    return _compression;
+  }
+
+  value_t count() const
+  {
+    return _weight;
+  }
+
+  // Number of centroids held after the last compress()
+  size_t size() const
+  {
+    return _centroids.size();
+  }
+
+  bool compressed() const
+  {
+    return _buffer.empty();
+  }
+
+  void add( value_t x, value_t weight = 1 )
+  {
+    _buffer.push_back( { x, weight } );
+    _weight += weight;
+    _min = std::min( _min, x );
+    _max = std::max( _max, x );
+
+    if ( _buffer.size() >= buffer_limit() )
+    {
+      compress();
+    }
+  }
+
+  void merge( const quantile_sketch_t& other )
+  {
+    if ( other._weight == 0 )
+    {
+      return;
+    }
+
+    _buffer.insert( _buffer.end(), other._centroids.begin(), other._centroids.end() );
+    _buffer.insert( _buffer.end(), other._buffer.begin(), other._buffer.end() );
+    _weight += other._weight;
+    _min = std::min( _min, other._min );
+    _max = std::max( _max, other._max );
+
+    compress();
+  }
+
+  // Fold buffered samples into the centroids
+  void compress()
+  {
+    if ( _buffer.empty() )
+    {
+      return;
+    }
+
+    _buffer.insert( _buffer.end(), _centroids.begin(), _centroids.end() );
+    range::sort( _buffer, []( const centroid_t& l, const centroid_t& r ) { return l.mean < r.mean; } );
+
+    _centroids.clear();
+    _centroids.push_back( _buffer.front() );
+
+    value_t weight_so_far = 0;
+    double limit = _weight * scale_inverse( scale( 0 ) + 1 );
+    for ( auto it = _buffer.begin() + 1; it != _buffer.end(); ++it )
+    {
+      auto& current = _centroids.back();
+      if ( weight_so_far + current.weight + it->weight <= limit )
+      {
+        current.weight += it->weight;
+        current.mean += ( it->mean - current.mean ) * it->weight / current.weight;
+      }
+      else
+      {
+        weight_so_far += current.weight;
+        limit = _weight * scale_inverse( scale( weight_so_far / _weight ) + 1 );
+        _centroids.push_back( *it );
+      }
+    }
+
+    _buffer.clear();
+  }
+
+  /* Estimated value at quantile q ( 0 <= q <= 1 ), interpolated between centroid centers.
+   * Requires: compress()
+   */
+  value_t quantile( double q ) const
+  {
+    assert( compressed() );
+
+    if ( _centroids.empty() )
+      return 0;
+
+    if ( _centroids.size() == 1 || q <= 0 )
+      return q <= 0 ? _min : _centroids.front().mean;
+
+    if ( q >= 1 )
+      return _max;
+
+    double index = q * _weight;
+
+    // Left tail, between the minimum and the first centroid center
+    const auto& first = _centroids.front();
+    if ( index < first.weight / 2 )
+    {
+      return _min + ( first.mean - _min ) * index / ( first.weight / 2 );
+    }
+
+    double cumulative = first.weight / 2;
+    for ( size_t i = 0; i + 1 < _centroids.size(); ++i )
+    {
+      const auto& l = _centroids[ i ];
+      const auto& r = _centroids[ i + 1 ];
+      double delta  = ( l.weight + r.weight ) / 2;
+      if ( cumulative + delta > index )
+      {
+        return l.mean + ( r.mean - l.mean ) * ( index - cumulative ) / delta;
+      }
+
+      cumulative += delta;
+    }
+
+    // Right tail, between the last centroid center and the maximum
+    const auto& last = _centroids.back();
+    double fraction  = std::min( 1.0, ( index - cumulative ) / ( last.weight / 2 ) );
+    return last.mean + ( _max - last.mean ) * fraction;
+  }
+
+  /* Estimated fraction of samples less than or equal to x.
+   * Requires: compress()
+   */
+  double cdf( value_t x ) const
+  {
+    assert( compressed() );
+
+    if ( _centroids.empty() || x < _min )
+      return 0;
+
+    if ( x >= _max )
+      return 1;
+
+    const auto& first = _centroids.front();
+    if ( x < first.mean )
+    {
+      return first.mean > _min ? ( x - _min ) / ( first.mean - _min ) * first.weight / 2 / _weight : 0;
+    }
+
+    double cumulative = first.weight / 2;
+    for ( size_t i = 0; i + 1 < _centroids.size(); ++i )
+    {
+      const auto& l = _centroids[ i ];
+      const auto& r = _centroids[ i + 1 ];
+      double delta  = ( l.weight + r.weight ) / 2;
+      if ( x < r.mean )
+      {
+        return ( cumulative + delta * ( x - l.mean ) / ( r.mean - l.mean ) ) / _weight;
+      }
+
+      cumulative += delta;
+    }
+
+    const auto& last = _centroids.back();
+    return ( cumulative + last.weight / 2 * ( x - last.mean ) / ( _max - last.mean ) ) / _weight;
+  }
+
+  void clear()
+  {
+    _min    = std::numeric_limits<value_t>::max();
+    _max    = std::numeric_limits<value_t>::lowest();
+    _weight = 0;
+    _centroids.clear();
+    _buffer.clear();
+  }
+};
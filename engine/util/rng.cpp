@@ -8,6 +8,11 @@
 #include <cstdint>
 #include <algorithm>
 
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#define SC_RNG_SSE2
+#include <emmintrin.h>
+#endif
+
 // Pseudo-Random Number Generation ==========================================
 
 namespace rng {
@@ -123,6 +128,107 @@ const char* xoshiro256plus_t::name() const noexcept
   return "xoshiro256+";
 }
 
+/**
+ * @brief Batched xoshiro256+ Random Number Generator
+ *
+ * Lanes are seeded with the xoshiro256 jump function, which is equivalent to 2^128 calls to next().
+ */
+void xoshiro256plus_batch_t::seed( uint64_t start ) noexcept
+{
+  static constexpr uint64_t JUMP[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+
+  std::array<uint64_t, 4> lane;
+  init_state_from_mix64( lane, start );
+
+  for ( size_t l = 0; l < LANES; ++l )
+  {
+    for ( size_t w = 0; w < 4; ++w )
+    {
+      s[ w ][ l ] = lane[ w ];
+    }
+
+    std::array<uint64_t, 4> jumped {};
+    for ( auto jump : JUMP )
+    {
+      for ( int b = 0; b < 64; ++b )
+      {
+        if ( jump & uint64_t( 1 ) << b )
+        {
+          for ( size_t w = 0; w < 4; ++w )
+          {
+            jumped[ w ] ^= lane[ w ];
+          }
+        }
+
+        // xoshiro256+ state transition
+        const uint64_t t = lane[ 1 ] << 17;
+        lane[ 2 ] ^= lane[ 0 ];
+        lane[ 3 ] ^= lane[ 1 ];
+        lane[ 1 ] ^= lane[ 2 ];
+        lane[ 0 ] ^= lane[ 3 ];
+        lane[ 2 ] ^= t;
+        lane[ 3 ] = rotl( lane[ 3 ], 45 );
+      }
+    }
+    lane = jumped;
+  }
+
+  index = BLOCK_SIZE;
+  blocks = 0;
+}
+
+void xoshiro256plus_batch_t::refill() noexcept
+{
+#if defined( SC_RNG_SSE2 )
+  // Two lanes per register
+  for ( size_t l = 0; l < LANES; l += 2 )
+  {
+    auto load = [ this, l ]( size_t w ) { return _mm_load_si128( reinterpret_cast<const __m128i*>( &s[ w ][ l ] ) ); };
+    __m128i s0 = load( 0 ), s1 = load( 1 ), s2 = load( 2 ), s3 = load( 3 );
+
+    for ( size_t i = l; i < BLOCK_SIZE; i += LANES )
+    {
+      _mm_store_si128( reinterpret_cast<__m128i*>( &buffer[ i ] ), _mm_add_epi64( s0, s3 ) );
+
+      const __m128i t = _mm_slli_epi64( s1, 17 );
+      s2 = _mm_xor_si128( s2, s0 );
+      s3 = _mm_xor_si128( s3, s1 );
+      s1 = _mm_xor_si128( s1, s2 );
+      s0 = _mm_xor_si128( s0, s3 );
+      s2 = _mm_xor_si128( s2, t );
+      s3 = _mm_or_si128( _mm_slli_epi64( s3, 45 ), _mm_srli_epi64( s3, 19 ) );
+    }
+
+    auto store = [ this, l ]( size_t w, __m128i v ) { _mm_store_si128( reinterpret_cast<__m128i*>( &s[ w ][ l ] ), v ); };
+    store( 0, s0 ); store( 1, s1 ); store( 2, s2 ); store( 3, s3 );
+  }
+#else
+  for ( size_t i = 0; i < BLOCK_SIZE; i += LANES )
+  {
+    for ( size_t l = 0; l < LANES; ++l )
+    {
+      buffer[ i + l ] = s[ 0 ][ l ] + s[ 3 ][ l ];
+
+      const uint64_t t = s[ 1 ][ l ] << 17;
+      s[ 2 ][ l ] ^= s[ 0 ][ l ];
+      s[ 3 ][ l ] ^= s[ 1 ][ l ];
+      s[ 1 ][ l ] ^= s[ 2 ][ l ];
+      s[ 0 ][ l ] ^= s[ 3 ][ l ];
+      s[ 2 ][ l ] ^= t;
+      s[ 3 ][ l ] = rotl( s[ 3 ][ l ], 45 );
+    }
+  }
+#endif
+
+  index = 0;
+  ++blocks;
+}
+
+const char* xoshiro256plus_batch_t::name() const noexcept
+{
+  return "xoshiro256+x8";
+}
+
 /**
  * @brief XORSHIFT-1024 Random Number Generator
  *
@@ -149,6 +255,77 @@ const char* xorshift1024_t::name() const noexcept
   return "xorshift1024";
 }
 
+/**
+ * @brief Philox4x32-10 counter-based Random Number Generator
+ *
+ * Salmon, Moraes, Dror, Shaw: "Parallel Random Numbers: As Easy as 1, 2, 3", SC11 (2011)
+ * https://www.thesalmons.org/john/random123/
+ */
+namespace {
+constexpr uint32_t PHILOX_M0 = 0xD2511F53;
+constexpr uint32_t PHILOX_M1 = 0xCD9E8D57;
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9;
+constexpr uint32_t PHILOX_W1 = 0xBB67AE85;
+
+std::array<uint32_t, 4> philox_block( std::array<uint32_t, 4> c, std::array<uint32_t, 2> k ) noexcept
+{
+  for ( int round = 0; round < 10; ++round )
+  {
+    const uint64_t p0 = uint64_t( PHILOX_M0 ) * c[ 0 ];
+    const uint64_t p1 = uint64_t( PHILOX_M1 ) * c[ 2 ];
+
+    c = { { uint32_t( p1 >> 32 ) ^ c[ 1 ] ^ k[ 0 ], uint32_t( p1 ),
+            uint32_t( p0 >> 32 ) ^ c[ 3 ] ^ k[ 1 ], uint32_t( p0 ) } };
+
+    k[ 0 ] += PHILOX_W0;
+    k[ 1 ] += PHILOX_W1;
+  }
+
+  return c;
+}
+} // anon namespace
+
+uint64_t philox4x32_t::next() noexcept
+{
+  if ( index == 4 )
+  {
+    block = philox_block( counter, key );
+    index = 0;
+
+    // Counter word 0 is the position within the stream
+    ++counter[ 0 ];
+  }
+
+  uint64_t result = ( uint64_t( block[ index ] ) << 32 ) | block[ index + 1 ];
+  index += 2;
+  return result;
+}
+
+void philox4x32_t::seed( uint64_t start ) noexcept
+{
+  key = { { uint32_t( start ), uint32_t( start >> 32 ) } };
+  stream( 0 );
+}
+
+void philox4x32_t::stream( uint64_t id, uint32_t sub_id ) noexcept
+{
+  counter = { { 0, sub_id, uint32_t( id ), uint32_t( id >> 32 ) } };
+  index = 4;
+}
+
+const char* philox4x32_t::name() const noexcept
+{
+  return "philox4x32";
+}
+
+uint64_t counter_seed( uint64_t seed, uint64_t id, uint32_t sub_id )
+{
+  philox4x32_t engine;
+  engine.seed( seed );
+  engine.stream( id, sub_id );
+  return engine.next();
+}
+
 /**
 * @brief The standard normal CDF, for one random variable.
 *
@@ -328,6 +505,74 @@ double stdnormal_inv( double p )
   return ( p > 0.5 ? -u : u );
 }
 
+namespace {
+// stdnormal_cdf sampled on [-8, 8] in steps of 1/16
+constexpr double CDF_TABLE_MIN = -8.0;
+constexpr double CDF_TABLE_STEPS = 16.0;
+
+std::array<double, 257> make_cdf_table()
+{
+  std::array<double, 257> table;
+  for ( size_t i = 0; i < table.size(); ++i )
+  {
+    table[ i ] = stdnormal_cdf( CDF_TABLE_MIN + i / CDF_TABLE_STEPS );
+  }
+  return table;
+}
+
+const std::array<double, 257> cdf_table = make_cdf_table();
+
+/**
+ * Build ziggurat layers for a decreasing density f with inverse f_inv, tail start r and layer area v.
+ * Each layer rectangle has area v, the top layer ends at x = 0.
+ */
+template <typename F, typename F_INV>
+ziggurat::table_t make_ziggurat( double r, double v, F f, F_INV f_inv )
+{
+  ziggurat::table_t t;
+  t.r = r;
+
+  t.x[ 0 ] = v / f( r );
+  t.f[ 0 ] = 0;
+  t.x[ 1 ] = r;
+  t.f[ 1 ] = f( r );
+  for ( size_t i = 1; i < 255; ++i )
+  {
+    t.f[ i + 1 ] = t.f[ i ] + v / t.x[ i ];
+    t.x[ i + 1 ] = f_inv( t.f[ i + 1 ] );
+  }
+  t.x[ 256 ] = 0;
+  t.f[ 256 ] = 1;
+
+  return t;
+}
+} // anon namespace
+
+double stdnormal_cdf_table( double u )
+{
+  double position = ( u - CDF_TABLE_MIN ) * CDF_TABLE_STEPS;
+  if ( !( position > 0 ) )
+    return 0.0;
+  if ( position >= cdf_table.size() - 1 )
+    return 1.0;
+
+  auto i = static_cast<size_t>( position );
+  return cdf_table[ i ] + ( position - i ) * ( cdf_table[ i + 1 ] - cdf_table[ i ] );
+}
+
+namespace ziggurat
+{
+const table_t normal = make_ziggurat(
+    3.6541528853610088, 4.92867323399e-3,
+    []( double x ) { return std::exp( -0.5 * x * x ); },
+    []( double y ) { return std::sqrt( -2.0 * std::log( y ) ); } );
+
+const table_t exponential = make_ziggurat(
+    7.69711747013104972, 3.9496598225815571993e-3,
+    []( double x ) { return std::exp( -x ); },
+    []( double y ) { return -std::log( y ); } );
+} // namespace ziggurat
+
 void truncated_gauss_t::calculate_cdf()
 {
 #ifndef NDEBUG
@@ -454,11 +699,120 @@ static void test_uniform_int( rng::basic_rng_t<Engine>& rng, uint64_t n, unsigne
   {
     double pct = static_cast<double>(histogram[ i ]) / n;
     double diff = static_cast<double>(histogram[ i ]) / expected_bucket_size - 1.0;
-    fmt::print("  bucket {:2n}: {:5.2f}% ({}) difference to expected: {:9.6f}%\n", i, pct, histogram[ i ], diff);
+    fmt::print("  bucket {:2d}: {:5.2f}% ({}) difference to expected: {:9.6f}%\n", i, pct, histogram[ i ], diff);
   }
   fmt::print("time = {} s\n\n", elapsed_cpu);
 }
 
+// Throughput of the distributions used in the simulation hot path. Note that the plain engines are
+// defined in this translation unit, and get inlined into the loops below. Elsewhere in the
+// simulator every draw from them is a function call, the batched engine serves draws inline.
+template <typename Engine>
+static void benchmark( rng::basic_rng_t<Engine>& rng, uint64_t n )
+{
+  auto run = [ &rng, n ]( const char* what, auto&& f ) {
+    auto start_time = test_clock::now();
+
+    double sum = 0;
+    for ( uint64_t i = 0; i < n; ++i )
+      sum += f();
+
+    auto elapsed_cpu = chrono::elapsed_fp_seconds( start_time );
+    fmt::print( "  {:<24} {:>10.3f} Mcalls/sec (average = {:.6f})\n", what, n / elapsed_cpu / 1e6, sum / n );
+  };
+
+  fmt::print( "{} ({}):\n", rng.name(), rng.ziggurat() ? "ziggurat" : "classic" );
+  run( "real()", [ &rng ] { return rng.real(); } );
+  run( "roll(0.3)", [ &rng ] { return rng.roll( 0.3 ) ? 1.0 : 0.0; } );
+  run( "gauss(0,1)", [ &rng ] { return rng.gauss( 0.0, 1.0 ); } );
+  run( "gauss_a(0.3,0.06,0)", [ &rng ] { return rng.gauss_a( 0.3, 0.06, 0.0 ); } );
+  run( "gauss_ab(0,1,1,2)", [ &rng ] { return rng.gauss_ab( 0.0, 1.0, 1.0, 2.0 ); } );
+  run( "exponential(0.25)", [ &rng ] { return rng.exponential( 0.25 ); } );
+  run( "exgauss(0.3,0.06,0.25)", [ &rng ] { return rng.exgauss( 0.3, 0.06, 0.25 ); } );
+  fmt::print( "\n" );
+}
+
+// Lane 0 of the batched engine must reproduce the plain xoshiro256+ sequence for the same seed
+static void test_batch_lanes( uint64_t seed )
+{
+  rng::xoshiro256plus_t plain;
+  rng::xoshiro256plus_batch_t batch;
+  plain.seed( seed );
+  batch.seed( seed );
+
+  size_t mismatches = 0;
+  for ( size_t i = 0; i < 100'000; ++i )
+  {
+    uint64_t value = batch.next();
+    if ( i % rng::xoshiro256plus_batch_t::LANES == 0 && value != plain.next() )
+      ++mismatches;
+  }
+
+  fmt::print( "{} lane 0 vs {}: {} mismatches\n\n", batch.name(), plain.name(), mismatches );
+}
+
+// Compare n samples against the expected distribution: mean, variance and the Kolmogorov-Smirnov
+// statistic D. With n = 1'000'000, D above ~0.0016 rejects the distribution at the 1% level.
+template <typename Engine, typename Sample, typename Cdf>
+static void test_distribution( rng::basic_rng_t<Engine>& rng, const char* what, uint64_t n, Sample sample,
+                               Cdf cdf, double expected_mean, double expected_variance )
+{
+  std::vector<double> values( n );
+  for ( auto& v : values )
+    v = sample();
+
+  range::sort( values );
+
+  double mean = 0, variance = 0, d = 0;
+  for ( uint64_t i = 0; i < n; ++i )
+  {
+    mean += values[ i ];
+    double c = cdf( values[ i ] );
+    d = std::max( { d, c - static_cast<double>( i ) / n, static_cast<double>( i + 1 ) / n - c } );
+  }
+  mean /= n;
+  for ( auto v : values )
+    variance += ( v - mean ) * ( v - mean );
+  variance /= n - 1;
+
+  fmt::print( "{} {}: mean = {:.5f} ({:.5f}), variance = {:.5f} ({:.5f}), KS D = {:.5f}\n",
+              rng.ziggurat() ? "ziggurat" : "classic ", what, mean, expected_mean, variance,
+              expected_variance, d );
+}
+
+// Truncated standard normal on [a..b]: mean and variance
+static std::pair<double, double> truncated_normal_moments( double a, double b )
+{
+  auto pdf = []( double x ) { return std::isinf( x ) ? 0.0 : std::exp( -0.5 * x * x ) / std::sqrt( 2 * m_pi ); };
+  double z    = rng::stdnormal_cdf( b ) - rng::stdnormal_cdf( a );
+  double mean = ( pdf( a ) - pdf( b ) ) / z;
+  double ta   = std::isinf( a ) ? 0.0 : a * pdf( a );
+  double tb   = std::isinf( b ) ? 0.0 : b * pdf( b );
+  return { mean, 1 + ( ta - tb ) / z - mean * mean };
+}
+
+template <typename Engine>
+static void test_distributions( rng::basic_rng_t<Engine>& rng, uint64_t n )
+{
+  auto normal_cdf = []( double x ) { return rng::stdnormal_cdf( x ); };
+  test_distribution( rng, "gauss(0,1)        ", n, [ &rng ] { return rng.gauss( 0.0, 1.0 ); }, normal_cdf, 0, 1 );
+
+  test_distribution( rng, "exponential(1)    ", n, [ &rng ] { return rng.exponential( 1.0 ); },
+                     []( double x ) { return 1 - std::exp( -x ); }, 1, 1 );
+
+  for ( auto [ a, b ] : { std::pair<double, double>{ -1, 0.5 }, { 1, 2 }, { -3, std::numeric_limits<double>::infinity() } } )
+  {
+    auto [ mean, variance ] = truncated_normal_moments( a, b );
+    double z = rng::stdnormal_cdf( b ) - rng::stdnormal_cdf( a );
+    test_distribution( rng, fmt::format( "gauss_ab(0,1,{},{})", a, b ).c_str(), n,
+                       [ &rng, a = a, b = b ] { return rng.gauss_ab( 0.0, 1.0, a, b ); },
+                       [ a = a, z ]( double x ) { return ( rng::stdnormal_cdf( x ) - rng::stdnormal_cdf( a ) ) / z; },
+                       mean, variance );
+  }
+
+  fmt::print( "\n" );
+}
+
 namespace detail {
 template <typename Tuple, typename F, std::size_t... I>
 void for_each_impl(Tuple&& t, F&& f, std::index_sequence<I...>)
@@ -475,13 +829,35 @@ void for_each(Tuple&& t, F&& f)
             std::make_index_sequence<std::tuple_size<std::remove_reference_t<Tuple>>::value>{});
 }
 
-int main( int /*argc*/, char** /*argv*/ )
+int main( int argc, char** argv )
 {
-  auto generators = std::make_tuple(
-    rng::basic_rng_t<rng::xoshiro256plus_t>{},
-    rng::basic_rng_t<rng::xorshift128_t>{},
-    rng::basic_rng_t<rng::xorshift1024_t>{}
-  );
+  // rng_test benchmark: compare the plain and batched engines only
+  if ( argc > 1 && std::string( argv[ 1 ] ) == "benchmark" )
+  {
+    const uint64_t n = argc > 2 ? std::stoull( argv[ 2 ] ) : 100'000'000;
+    rng::basic_rng_t<rng::xoshiro256plus_t> plain;
+    rng::basic_rng_t<rng::xoshiro256plus_batch_t> batch;
+    plain.seed( 31459 );
+    batch.seed( 31459 );
+
+    test_batch_lanes( 31459 );
+    plain.ziggurat( false );
+    batch.ziggurat( false );
+    benchmark( plain, n );
+    benchmark( batch, n );
+    batch.ziggurat( true );
+    benchmark( batch, n );
+    return 0;
+  }
+
+  // Generators are neither copyable nor movable, construct them in place
+  std::tuple<
+    rng::basic_rng_t<rng::xoshiro256plus_t>,
+    rng::basic_rng_t<rng::xoshiro256plus_batch_t>,
+    rng::basic_rng_t<rng::xorshift128_t>,
+    rng::basic_rng_t<rng::xorshift1024_t>,
+    rng::basic_rng_t<rng::philox4x32_t>
+  > generators;
 
   std::random_device rd;
   uint64_t seed  = uint64_t(rd()) | (uint64_t(rd()) << 32);
@@ -502,6 +878,12 @@ int main( int /*argc*/, char** /*argv*/ )
   auto& rng = std::get<0>( generators );
   fmt::print( "Testing {}\n\n", rng.name() );
 
+  for ( bool ziggurat : { false, true } )
+  {
+    rng.ziggurat( ziggurat );
+    test_distributions( rng, 1'000'000 );
+  }
+
   const uint64_t n = 100'000'000;
 
   // double gauss
@@ -29,6 +29,34 @@ namespace rng {
 double stdnormal_cdf( double u );
 double stdnormal_inv( double u );
 
+/// Table lookup approximation of stdnormal_cdf, absolute error below 2e-4
+double stdnormal_cdf_table( double u );
+
+/**
+ * @brief Ziggurat tables for the normal and exponential distributions
+ *
+ * 256 layers of equal area under the (unnormalized) density f. Layer 0 is the base strip, which
+ * includes the tail beyond x[ 1 ] = r; layer i > 0 is the rectangle [ 0, x[ i ] ] x [ f[ i ], f[ i + 1 ] ].
+ *
+ * Marsaglia, Tsang: "The Ziggurat Method for Generating Random Variables", JSS 5(8) (2000)
+ */
+namespace ziggurat
+{
+struct table_t
+{
+  double r;
+  std::array<double, 257> x;
+  std::array<double, 257> f;
+};
+
+extern const table_t normal;
+extern const table_t exponential;
+
+/// Minimum probability mass of a truncated normal interval for which rejection sampling from
+/// the ziggurat is used instead of CDF inversion.
+constexpr double TRUNCATED_REJECTION_MASS = 0.1;
+} // namespace ziggurat
+
 // CDF cached truncated timespan_t gaussian distribution
 // This is ~2x slower than non-truncated basic_rng_t::gauss( double, double )
 struct truncated_gauss_t
@@ -89,6 +117,21 @@ public:
   /// Reset any state
   void reset();
 
+  /// Sample normal and exponential distributions with the ziggurat method, instead of polar
+  /// Box-Muller, logarithms and CDF inversion ( default ).
+  void ziggurat( bool enable ) {
+    use_ziggurat = enable;
+  }
+
+  bool ziggurat() const {
+    return use_ziggurat;
+  }
+
+  /// Stream position, changes whenever random numbers are drawn. Requires engine support.
+  uint64_t position() const {
+    return 2 * engine.position() + gauss_pair_use;
+  }
+
   /// Uniform distribution in range [0..1)
   double real();
 
@@ -196,7 +239,18 @@ public:
   }
 
 private:
+  /// Standard normal and exponential ( nu = 1 ) variates using the ziggurat tables
+  double ziggurat_normal();
+  double ziggurat_exponential();
+
+  /// Standard normal variate truncated to [a..b], by rejection from the ziggurat
+  double ziggurat_normal_ab( double a, double b );
+
+protected:
   Engine engine;
+
+private:
+  bool use_ziggurat = false;
   // Allow re-use of unused ( but necessary ) random number of a previous call to gauss()
   double gauss_pair_value = 0.0;
   bool   gauss_pair_use = false;
@@ -300,6 +354,9 @@ double basic_rng_t<Engine>::gauss( double mean, double stddev )
   if ( stddev == 0 )
     return mean;
 
+  if ( use_ziggurat )
+    return mean + ziggurat_normal() * stddev;
+
   if ( gauss_pair_use )
   {
     gauss_pair_use = false;
@@ -340,6 +397,15 @@ double basic_rng_t<Engine>::gauss_ab( double mean, double stddev, double min, do
   if ( min == max )
     return min;
 
+  // Rejection from the ziggurat, unless the interval holds too little of the distribution
+  if ( use_ziggurat )
+  {
+    double a = ( min - mean ) / stddev;
+    double b = ( max - mean ) / stddev;
+    if ( stdnormal_cdf_table( b ) - stdnormal_cdf_table( a ) >= ziggurat::TRUNCATED_REJECTION_MASS )
+      return mean + stddev * ziggurat_normal_ab( a, b );
+  }
+
   double min_cdf      = stdnormal_cdf( ( min - mean ) / stddev );
   double max_cdf      = stdnormal_cdf( ( max - mean ) / stddev );
   double uniform      = real();
@@ -363,6 +429,9 @@ double basic_rng_t<Engine>::gauss_b( double mean, double stddev, double max )
 template <typename Engine>
 double basic_rng_t<Engine>::exponential( double nu )
 {
+  if ( use_ziggurat )
+    return ziggurat_exponential() * nu;
+
   double x;
   do { x = real(); } while ( x >= 1.0 ); // avoid ln(k) where k <= 0. this should be guaranteed by `real()`, but just in case
   return - std::log( 1 - x ) * nu;
@@ -438,7 +507,18 @@ timespan_t basic_rng_t<Engine>::gauss( truncated_gauss_t& g )
     return g.mean;
 
   g.calculate_cdf();
-  
+
+  if ( use_ziggurat && g.max_cdf() - g.min_cdf() >= ziggurat::TRUNCATED_REJECTION_MASS )
+  {
+    auto mean   = static_cast<double>( timespan_t::to_native( g.mean ) );
+    auto stddev = static_cast<double>( timespan_t::to_native( g.stddev ) );
+    auto a      = ( static_cast<double>( timespan_t::to_native( g.min ) ) - mean ) / stddev;
+    auto b      = g.max == timespan_t::min()
+                ? std::numeric_limits<double>::infinity()
+                : ( static_cast<double>( timespan_t::to_native( g.max ) ) - mean ) / stddev;
+    return timespan_t::from_native( mean + stddev * ziggurat_normal_ab( a, b ) );
+  }
+
   double rescaled = g.min_cdf() + real() * ( g.max_cdf() - g.min_cdf() );
   return timespan_t::from_native( timespan_t::to_native( g.mean ) +
                                   timespan_t::to_native( g.stddev ) * stdnormal_inv( rescaled ) );
@@ -469,11 +549,89 @@ timespan_t basic_rng_t<Engine>::gauss()
     assert( min_cdf == stdnormal_cdf( ( 0.0 - mean ) / stddev ) );
     assert( max_cdf == stdnormal_cdf( ( std::numeric_limits<double>::infinity() - mean ) / stddev ) );
 
+    if ( use_ziggurat && max_cdf - min_cdf >= ziggurat::TRUNCATED_REJECTION_MASS )
+    {
+      return timespan_t::from_native(
+          mean + stddev * ziggurat_normal_ab( ( 0.0 - mean ) / stddev, std::numeric_limits<double>::infinity() ) );
+    }
+
     double rescaled = min_cdf + real() * ( max_cdf - min_cdf );
     return timespan_t::from_native( mean + stddev * stdnormal_inv( rescaled ) );
   }
 }
 
+/**
+ * @brief Ziggurat normal distribution
+ *
+ * A single 64-bit draw provides the layer ( high 8 bits ) and a signed uniform position within the
+ * layer ( the next 53 bits ). The low bits of xoshiro256+ output are its weakest, the lowest three
+ * are not used. Around 99% of the draws are accepted without evaluating the density.
+ */
+template <typename Engine>
+double basic_rng_t<Engine>::ziggurat_normal()
+{
+  const auto& t = ziggurat::normal;
+  for ( ;; )
+  {
+    uint64_t u = engine.next();
+    unsigned i = static_cast<unsigned>( u >> 56 );
+    double x = static_cast<int64_t>( u << 8 ) / 2048 * 0x1.0p-52 * t.x[ i ];
+
+    if ( std::fabs( x ) < t.x[ i + 1 ] )
+      return x;
+
+    if ( i == 0 )
+    {
+      // Tail beyond r, Marsaglia 1964
+      double a, b;
+      do
+      {
+        a = -std::log( 1.0 - real() ) / t.r;
+        b = -std::log( 1.0 - real() );
+      } while ( b + b < a * a );
+      return x < 0 ? -( t.r + a ) : t.r + a;
+    }
+
+    if ( t.f[ i ] + real() * ( t.f[ i + 1 ] - t.f[ i ] ) < std::exp( -0.5 * x * x ) )
+      return x;
+  }
+}
+
+/// Ziggurat exponential distribution, see ziggurat_normal()
+template <typename Engine>
+double basic_rng_t<Engine>::ziggurat_exponential()
+{
+  const auto& t = ziggurat::exponential;
+  for ( ;; )
+  {
+    uint64_t u = engine.next();
+    unsigned i = static_cast<unsigned>( u >> 56 );
+    double x = static_cast<int64_t>( ( u << 8 ) >> 11 ) * 0x1.0p-53 * t.x[ i ];
+
+    if ( x < t.x[ i + 1 ] )
+      return x;
+
+    // The exponential distribution is memoryless, the tail is a shifted copy of it
+    if ( i == 0 )
+      return t.r - std::log( 1.0 - real() );
+
+    if ( t.f[ i ] + real() * ( t.f[ i + 1 ] - t.f[ i ] ) < std::exp( -x ) )
+      return x;
+  }
+}
+
+template <typename Engine>
+double basic_rng_t<Engine>::ziggurat_normal_ab( double a, double b )
+{
+  double z;
+  do
+  {
+    z = ziggurat_normal();
+  } while ( z < a || z > b );
+
+  return z;
+}
+
 /// RNG Engines
 
 /**
@@ -510,6 +668,51 @@ private:
   std::array<uint64_t, 4> s;
 };
 
+/**
+ * @brief Batched xoshiro256+ Random Number Generator
+ *
+ * Runs LANES independent xoshiro256+ generators side by side, with the state laid out so that all
+ * lanes advance with the same vector instructions. Output is generated BLOCK_SIZE values at a
+ * time into a buffer, and served from it one by one. Lane i starts i jumps ( 2^128 steps ) ahead
+ * of lane 0, so the lane sequences do not overlap.
+ *
+ * Lane 0 runs the xoshiro256plus_t sequence of the same seed, but next() serves the lanes
+ * interleaved ( lane 0 provides every LANES'th value ), so the served sequence differs from the
+ * one of xoshiro256plus_t.
+ */
+struct xoshiro256plus_batch_t
+{
+  static constexpr size_t LANES = 8;
+  static constexpr size_t BLOCK_SIZE = 16 * LANES;
+
+  uint64_t next() noexcept
+  {
+    if ( index == BLOCK_SIZE )
+    {
+      refill();
+    }
+
+    return buffer[ index++ ];
+  }
+
+  /// Number of values produced since seeding, including unserved buffered values
+  uint64_t position() const noexcept
+  {
+    return blocks * BLOCK_SIZE + index;
+  }
+
+  void seed( uint64_t start ) noexcept;
+  const char* name() const noexcept;
+private:
+  void refill() noexcept;
+
+  // s[ word ][ lane ]
+  alignas( 16 ) std::array<std::array<uint64_t, LANES>, 4> s;
+  alignas( 16 ) std::array<uint64_t, BLOCK_SIZE> buffer;
+  size_t index = BLOCK_SIZE;
+  uint64_t blocks = 0;
+};
+
 /**
  * @brief XORSHIFT-1024 Random Number Generator
  *
@@ -526,8 +729,107 @@ private:
   int p;
 };
 
+/**
+ * @brief Philox4x32-10 counter-based Random Number Generator
+ *
+ * Output is a keyed bijection of a 128-bit counter, so any position of any stream can be generated
+ * directly, without generating the values before it. The key is the seed, the counter holds the
+ * position of the value in the stream.
+ *
+ * Salmon, Moraes, Dror, Shaw: "Parallel Random Numbers: As Easy as 1, 2, 3", SC11 (2011)
+ */
+struct philox4x32_t
+{
+  uint64_t next() noexcept;
+  void seed( uint64_t start ) noexcept;
+  const char* name() const noexcept;
+
+  /// Position the generator at the start of the given stream
+  void stream( uint64_t id, uint32_t sub_id = 0 ) noexcept;
+private:
+  std::array<uint32_t, 2> key;
+  std::array<uint32_t, 4> counter;
+  std::array<uint32_t, 4> block;
+  unsigned index = 4;
+};
+
+/// First value of stream ( id, sub_id ) of a Philox generator keyed with seed. Used to derive
+/// independent seeds for other generators, e.g., one per iteration.
+uint64_t counter_seed( uint64_t seed, uint64_t id, uint32_t sub_id = 0 );
+
+/**
+ * @brief Default engine of the simulator
+ *
+ * xoshiro256+, or optionally its batched version ( xoshiro256plus_batch_t ), selected at runtime.
+ * Counts the values drawn from the plain engine, so the stream position is known in both modes.
+ */
+struct default_engine_t
+{
+  uint64_t next() noexcept
+  {
+    if ( use_batch )
+    {
+      return batch_engine.next();
+    }
+
+    ++plain_position;
+    return plain_engine.next();
+  }
+
+  uint64_t position() const noexcept
+  {
+    return use_batch ? batch_engine.position() : plain_position;
+  }
+
+  void seed( uint64_t start ) noexcept
+  {
+    if ( use_batch )
+    {
+      batch_engine.seed( start );
+    }
+    else
+    {
+      plain_engine.seed( start );
+      plain_position = 0;
+    }
+  }
+
+  const char* name() const noexcept
+  {
+    return use_batch ? batch_engine.name() : plain_engine.name();
+  }
+
+  /// Select the batched engine, takes effect on the next seed()
+  void batch( bool enable ) noexcept
+  {
+    use_batch = enable;
+  }
+
+  bool batch() const noexcept
+  {
+    return use_batch;
+  }
+private:
+  xoshiro256plus_t plain_engine;
+  xoshiro256plus_batch_t batch_engine;
+  uint64_t plain_position = 0;
+  bool use_batch = false;
+};
+
 // "Default" rng
 // Explicitly *NOT* a type alias to allow forward declaraions
-struct rng_t : public basic_rng_t<xoshiro256plus_t> {};
+struct rng_t : public basic_rng_t<default_engine_t>
+{
+  /// Draw from the batched xoshiro256+ engine, must be set before seeding
+  void batch( bool enable )
+  {
+    engine.batch( enable );
+  }
+
+  bool batch() const
+  {
+    return engine.batch();
+  }
+};
 
 } // rng
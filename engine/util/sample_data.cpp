@@ -0,0 +1,382 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#include "sample_data.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#define SC_STATISTICS_X86
+#include <immintrin.h>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+#endif
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define SC_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#else
+#define SC_TARGET_AVX2
+#endif
+
+namespace
+{
+// Scalar kernels, used on non-x86 platforms and for the tail end of vectorized loops
+
+double sum_scalar( const double* data, size_t n )
+{
+  double sum = 0;
+  for ( size_t i = 0; i < n; ++i )
+  {
+    sum += data[ i ];
+  }
+  return sum;
+}
+
+double squared_deviation_sum_scalar( const double* data, size_t n, double mean )
+{
+  double sum = 0;
+  for ( size_t i = 0; i < n; ++i )
+  {
+    sum += ( data[ i ] - mean ) * ( data[ i ] - mean );
+  }
+  return sum;
+}
+
+void minmax_scalar( const double* data, size_t n, double& min, double& max )
+{
+  for ( size_t i = 0; i < n; ++i )
+  {
+    min = std::min( min, data[ i ] );
+    max = std::max( max, data[ i ] );
+  }
+}
+
+void add_scalar( double* data, const double* other, size_t n )
+{
+  for ( size_t i = 0; i < n; ++i )
+  {
+    data[ i ] += other[ i ];
+  }
+}
+
+void divide_scalar( double* data, const double* divisor, size_t n )
+{
+  for ( size_t i = 0; i < n; ++i )
+  {
+    data[ i ] /= divisor[ i ];
+  }
+}
+
+size_t bucket_index( double value, double min, double range, size_t num_buckets )
+{
+  auto position = ( value - min ) / range;
+  auto index    = static_cast<size_t>( num_buckets * position );
+  // if value == max, we want to downgrade it into the last bucket
+  if ( index == num_buckets )
+    --index;
+  assert( index < num_buckets );
+  return index;
+}
+
+void histogram_scalar( const double* data, size_t n, double min, double max, size_t* buckets,
+                       size_t num_buckets )
+{
+  auto range = max - min;
+  for ( size_t i = 0; i < n; ++i )
+  {
+    buckets[ bucket_index( data[ i ], min, range, num_buckets ) ]++;
+  }
+}
+
+#if defined( SC_STATISTICS_X86 )
+// SSE2 kernels, two doubles per instruction. Always available on x86-64.
+
+double horizontal_sum( __m128d v )
+{
+  return _mm_cvtsd_f64( _mm_add_sd( v, _mm_unpackhi_pd( v, v ) ) );
+}
+
+double sum_sse2( const double* data, size_t n )
+{
+  __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+  size_t i     = 0;
+  for ( ; i + 4 <= n; i += 4 )
+  {
+    acc0 = _mm_add_pd( acc0, _mm_loadu_pd( data + i ) );
+    acc1 = _mm_add_pd( acc1, _mm_loadu_pd( data + i + 2 ) );
+  }
+
+  return horizontal_sum( _mm_add_pd( acc0, acc1 ) ) + sum_scalar( data + i, n - i );
+}
+
+double squared_deviation_sum_sse2( const double* data, size_t n, double mean )
+{
+  __m128d m    = _mm_set1_pd( mean );
+  __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+  size_t i     = 0;
+  for ( ; i + 4 <= n; i += 4 )
+  {
+    __m128d d0 = _mm_sub_pd( _mm_loadu_pd( data + i ), m );
+    __m128d d1 = _mm_sub_pd( _mm_loadu_pd( data + i + 2 ), m );
+    acc0       = _mm_add_pd( acc0, _mm_mul_pd( d0, d0 ) );
+    acc1       = _mm_add_pd( acc1, _mm_mul_pd( d1, d1 ) );
+  }
+
+  return horizontal_sum( _mm_add_pd( acc0, acc1 ) ) + squared_deviation_sum_scalar( data + i, n - i, mean );
+}
+
+void minmax_sse2( const double* data, size_t n, double& min, double& max )
+{
+  __m128d vmin = _mm_set1_pd( min ), vmax = _mm_set1_pd( max );
+  size_t i     = 0;
+  for ( ; i + 2 <= n; i += 2 )
+  {
+    __m128d v = _mm_loadu_pd( data + i );
+    vmin      = _mm_min_pd( vmin, v );
+    vmax      = _mm_max_pd( vmax, v );
+  }
+
+  min = _mm_cvtsd_f64( _mm_min_sd( vmin, _mm_unpackhi_pd( vmin, vmin ) ) );
+  max = _mm_cvtsd_f64( _mm_max_sd( vmax, _mm_unpackhi_pd( vmax, vmax ) ) );
+  minmax_scalar( data + i, n - i, min, max );
+}
+
+void add_sse2( double* data, const double* other, size_t n )
+{
+  size_t i = 0;
+  for ( ; i + 2 <= n; i += 2 )
+  {
+    _mm_storeu_pd( data + i, _mm_add_pd( _mm_loadu_pd( data + i ), _mm_loadu_pd( other + i ) ) );
+  }
+
+  add_scalar( data + i, other + i, n - i );
+}
+
+void divide_sse2( double* data, const double* divisor, size_t n )
+{
+  size_t i = 0;
+  for ( ; i + 2 <= n; i += 2 )
+  {
+    _mm_storeu_pd( data + i, _mm_div_pd( _mm_loadu_pd( data + i ), _mm_loadu_pd( divisor + i ) ) );
+  }
+
+  divide_scalar( data + i, divisor + i, n - i );
+}
+
+// AVX2 kernels, four doubles per instruction. Compiled for AVX2 regardless of the global
+// compiler flags, and only called if the CPU supports it.
+
+SC_TARGET_AVX2 double horizontal_sum_avx2( __m256d v )
+{
+  __m128d lo = _mm256_castpd256_pd128( v );
+  __m128d hi = _mm256_extractf128_pd( v, 1 );
+  lo         = _mm_add_pd( lo, hi );
+  return _mm_cvtsd_f64( _mm_add_sd( lo, _mm_unpackhi_pd( lo, lo ) ) );
+}
+
+SC_TARGET_AVX2 double sum_avx2( const double* data, size_t n )
+{
+  __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+  size_t i     = 0;
+  for ( ; i + 8 <= n; i += 8 )
+  {
+    acc0 = _mm256_add_pd( acc0, _mm256_loadu_pd( data + i ) );
+    acc1 = _mm256_add_pd( acc1, _mm256_loadu_pd( data + i + 4 ) );
+  }
+
+  return horizontal_sum_avx2( _mm256_add_pd( acc0, acc1 ) ) + sum_scalar( data + i, n - i );
+}
+
+SC_TARGET_AVX2 double squared_deviation_sum_avx2( const double* data, size_t n, double mean )
+{
+  __m256d m    = _mm256_set1_pd( mean );
+  __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+  size_t i     = 0;
+  for ( ; i + 8 <= n; i += 8 )
+  {
+    __m256d d0 = _mm256_sub_pd( _mm256_loadu_pd( data + i ), m );
+    __m256d d1 = _mm256_sub_pd( _mm256_loadu_pd( data + i + 4 ), m );
+    acc0       = _mm256_add_pd( acc0, _mm256_mul_pd( d0, d0 ) );
+    acc1       = _mm256_add_pd( acc1, _mm256_mul_pd( d1, d1 ) );
+  }
+
+  return horizontal_sum_avx2( _mm256_add_pd( acc0, acc1 ) ) +
+         squared_deviation_sum_scalar( data + i, n - i, mean );
+}
+
+SC_TARGET_AVX2 void minmax_avx2( const double* data, size_t n, double& min, double& max )
+{
+  __m256d vmin = _mm256_set1_pd( min ), vmax = _mm256_set1_pd( max );
+  size_t i     = 0;
+  for ( ; i + 4 <= n; i += 4 )
+  {
+    __m256d v = _mm256_loadu_pd( data + i );
+    vmin      = _mm256_min_pd( vmin, v );
+    vmax      = _mm256_max_pd( vmax, v );
+  }
+
+  __m128d lo_min = _mm_min_pd( _mm256_castpd256_pd128( vmin ), _mm256_extractf128_pd( vmin, 1 ) );
+  __m128d lo_max = _mm_max_pd( _mm256_castpd256_pd128( vmax ), _mm256_extractf128_pd( vmax, 1 ) );
+  min = _mm_cvtsd_f64( _mm_min_sd( lo_min, _mm_unpackhi_pd( lo_min, lo_min ) ) );
+  max = _mm_cvtsd_f64( _mm_max_sd( lo_max, _mm_unpackhi_pd( lo_max, lo_max ) ) );
+  minmax_scalar( data + i, n - i, min, max );
+}
+
+SC_TARGET_AVX2 void add_avx2( double* data, const double* other, size_t n )
+{
+  size_t i = 0;
+  for ( ; i + 4 <= n; i += 4 )
+  {
+    _mm256_storeu_pd( data + i, _mm256_add_pd( _mm256_loadu_pd( data + i ), _mm256_loadu_pd( other + i ) ) );
+  }
+
+  add_scalar( data + i, other + i, n - i );
+}
+
+SC_TARGET_AVX2 void divide_avx2( double* data, const double* divisor, size_t n )
+{
+  size_t i = 0;
+  for ( ; i + 4 <= n; i += 4 )
+  {
+    _mm256_storeu_pd( data + i, _mm256_div_pd( _mm256_loadu_pd( data + i ), _mm256_loadu_pd( divisor + i ) ) );
+  }
+
+  divide_scalar( data + i, divisor + i, n - i );
+}
+
+// Bucket positions are computed four at a time with the same operations as the scalar version,
+// the bucket counters are incremented one by one.
+SC_TARGET_AVX2 void histogram_avx2( const double* data, size_t n, double min, double max, size_t* buckets,
+                                    size_t num_buckets )
+{
+  auto range     = max - min;
+  __m256d vmin   = _mm256_set1_pd( min );
+  __m256d vrange = _mm256_set1_pd( range );
+  __m256d vn     = _mm256_set1_pd( static_cast<double>( num_buckets ) );
+  __m128i vlast  = _mm_set1_epi32( static_cast<int>( num_buckets - 1 ) );
+  alignas( 16 ) int32_t index[ 4 ];
+
+  size_t i = 0;
+  for ( ; i + 4 <= n; i += 4 )
+  {
+    __m256d position = _mm256_div_pd( _mm256_sub_pd( _mm256_loadu_pd( data + i ), vmin ), vrange );
+    __m128i idx      = _mm256_cvttpd_epi32( _mm256_mul_pd( vn, position ) );
+    _mm_store_si128( reinterpret_cast<__m128i*>( index ), _mm_min_epi32( idx, vlast ) );
+
+    for ( int32_t b : index )
+    {
+      assert( b >= 0 && static_cast<size_t>( b ) < num_buckets );
+      buckets[ b ]++;
+    }
+  }
+
+  histogram_scalar( data + i, n - i, min, max, buckets, num_buckets );
+}
+
+bool cpu_supports_avx2()
+{
+#if defined( _MSC_VER )
+  int info[ 4 ];
+  __cpuid( info, 0 );
+  if ( info[ 0 ] < 7 )
+  {
+    return false;
+  }
+
+  // OS must save the AVX register state
+  __cpuid( info, 1 );
+  bool osxsave = ( info[ 2 ] & ( 1 << 27 ) ) != 0;
+  if ( !osxsave || ( _xgetbv( 0 ) & 0x6 ) != 0x6 )
+  {
+    return false;
+  }
+
+  __cpuidex( info, 7, 0 );
+  return ( info[ 1 ] & ( 1 << 5 ) ) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports( "avx2" );
+#endif
+}
+#endif /* SC_STATISTICS_X86 */
+
+struct kernels_t
+{
+  const char* name;
+  double ( *sum )( const double*, size_t );
+  double ( *squared_deviation_sum )( const double*, size_t, double );
+  void ( *minmax )( const double*, size_t, double&, double& );
+  void ( *histogram )( const double*, size_t, double, double, size_t*, size_t );
+  void ( *add )( double*, const double*, size_t );
+  void ( *divide )( double*, const double*, size_t );
+};
+
+kernels_t select_kernels()
+{
+#if defined( SC_STATISTICS_X86 )
+  if ( cpu_supports_avx2() )
+  {
+    return { "avx2", sum_avx2, squared_deviation_sum_avx2, minmax_avx2, histogram_avx2, add_avx2, divide_avx2 };
+  }
+
+  return { "sse2", sum_sse2, squared_deviation_sum_sse2, minmax_sse2, histogram_scalar, add_sse2, divide_sse2 };
+#else
+  return { "scalar", sum_scalar, squared_deviation_sum_scalar, minmax_scalar, histogram_scalar, add_scalar,
+           divide_scalar };
+#endif
+}
+
+const kernels_t& kernels()
+{
+  static const kernels_t k = select_kernels();
+  return k;
+}
+}  // unnamed namespace
+
+namespace statistics
+{
+namespace kernel
+{
+const char* instruction_set()
+{
+  return kernels().name;
+}
+
+double sum( const double* data, size_t n )
+{
+  return kernels().sum( data, n );
+}
+
+double squared_deviation_sum( const double* data, size_t n, double mean )
+{
+  return kernels().squared_deviation_sum( data, n, mean );
+}
+
+void minmax( const double* data, size_t n, double& min, double& max )
+{
+  min = std::numeric_limits<double>::max();
+  max = std::numeric_limits<double>::lowest();
+  kernels().minmax( data, n, min, max );
+}
+
+void histogram( const double* data, size_t n, double min, double max, size_t* buckets, size_t num_buckets )
+{
+  kernels().histogram( data, n, min, max, buckets, num_buckets );
+}
+
+void add( double* data, const double* other, size_t n )
+{
+  kernels().add( data, other, n );
+}
+
+void divide( double* data, const double* divisor, size_t n )
+{
+  kernels().divide( data, divisor, n );
+}
+}  // namespace kernel
+}  // namespace statistics
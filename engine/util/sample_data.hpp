@@ -6,12 +6,14 @@
 #ifndef SAMPLE_DATA_HPP
 #define SAMPLE_DATA_HPP
 
+#include <cmath>
 #include <limits>
 #include <numeric>
 #include <string>
 #include <vector>
 
 #include "util/generic.hpp"
+#include "util/quantile_sketch.hpp"
 #include "util/string_view.hpp"
 
 /* Collection of statistical formulas for sequences
@@ -19,6 +21,59 @@
  */
 namespace statistics
 {
+/* Vectorized kernels for contiguous sequences of doubles. The instruction set ( AVX2, SSE2 or
+ * scalar ) is selected on first use based on the CPU the sim runs on.
+ */
+namespace kernel
+{
+const char* instruction_set();
+double sum( const double* data, size_t n );
+double squared_deviation_sum( const double* data, size_t n, double mean );
+void minmax( const double* data, size_t n, double& min, double& max );
+void histogram( const double* data, size_t n, double min, double max, size_t* buckets, size_t num_buckets );
+// Element-wise data[ i ] += other[ i ]
+void add( double* data, const double* other, size_t n );
+// Element-wise data[ i ] /= divisor[ i ]
+void divide( double* data, const double* divisor, size_t n );
+}  // namespace kernel
+
+/* Overloads of the generic formulas below for sample vectors, using the kernels
+ */
+inline double calculate_sum( const std::vector<double>& r )
+{
+  return kernel::sum( r.data(), r.size() );
+}
+
+inline double calculate_variance( const std::vector<double>& r, double mean )
+{
+  auto tmp = kernel::squared_deviation_sum( r.data(), r.size(), mean );
+  if ( r.size() > 1 )
+    tmp /= r.size();
+  return tmp;
+}
+
+inline std::vector<size_t> create_histogram( const std::vector<double>& r, size_t num_buckets,
+                                             double min, double max )
+{
+  std::vector<size_t> result;
+  if ( r.empty() )
+    return result;
+
+  if ( std::isnan( min ) || std::isnan( max ) )
+    return result;
+
+  assert( min <= *range::min_element( r ) );
+  assert( max >= *range::max_element( r ) );
+
+  if ( max <= min )
+    return result;
+
+  result.assign( num_buckets, size_t{} );
+  kernel::histogram( r.data(), r.size(), min, max, result.data(), num_buckets );
+
+  return result;
+}
+
 /* Arithmetic Sum
  */
 template <typename Range>
@@ -190,6 +245,75 @@ inline std::vector<double> normalize_histogram( const std::vector<size_t>& in )
 
 }  // end sd namespace
 
+/* Running count, mean and sum of squared deviations of a sequence ( Welford ). Two sets of
+ * moments can be combined exactly ( Chan et al. ), so per-thread moments can be merged, and
+ * a copy serves as a cheap snapshot of the sequence so far.
+ */
+class running_moments_t
+{
+public:
+  using value_t = double;
+
+private:
+  size_t _count = 0;
+  value_t _mean = 0;
+  value_t _m2   = 0;
+
+public:
+  void add( value_t x )
+  {
+    ++_count;
+    value_t delta = x - _mean;
+    _mean += delta / _count;
+    _m2 += delta * ( x - _mean );
+  }
+
+  void merge( const running_moments_t& other )
+  {
+    if ( other._count == 0 )
+      return;
+
+    auto n_a   = static_cast<value_t>( _count );
+    auto n_b   = static_cast<value_t>( other._count );
+    auto delta = other._mean - _mean;
+
+    _count += other._count;
+    _mean += delta * n_b / _count;
+    _m2 += other._m2 + delta * delta * n_a * n_b / _count;
+  }
+
+  size_t count() const
+  {
+    return _count;
+  }
+
+  value_t mean() const
+  {
+    return _mean;
+  }
+
+  /* Expected Value of the squared deviation, see statistics::calculate_variance
+   */
+  value_t variance() const
+  {
+    return _count > 1 ? _m2 / _count : 0;
+  }
+
+  /* Standard Deviation of the sample mean distribution, see
+   * statistics::calculate_mean_stddev
+   */
+  value_t mean_std_dev() const
+  {
+    return _count > 1 ? std::sqrt( variance() / _count ) : 0;
+  }
+
+  void reset()
+  {
+    _count = 0;
+    _mean = _m2 = 0;
+  }
+};
+
 /* Simplest Samplest Data container. Only tracks sum and count
  *
  */
@@ -307,6 +431,10 @@ public:
 /* Extensive sample_data container with two runtime dependent modes:
  * - simple: Only offers sum, count
  *  -!simple: saves data and offers variance, percentiles, distribution, etc.
+ *
+ * A !simple container can alternatively be switched to a sketched mode, which does not save
+ * data, but keeps exact mean/variance/min/max and a bounded-memory quantile sketch for
+ * percentiles and distribution. data() and sorted_data() stay empty in sketched mode.
  */
 class extended_sample_data_t : public simple_sample_data_with_min_max_t
 {
@@ -325,6 +453,9 @@ private:
                                       // original, unsorted order ( for example
                                       // to do regression on it )
   bool is_sorted;
+  bool is_sketched;
+  quantile_sketch_t _sketch;
+  running_moments_t _moments;
 
 public:
   explicit extended_sample_data_t( util::string_view n, bool s = true )
@@ -336,7 +467,10 @@ public:
       mean_variance(),
       mean_std_dev(),
       simple( s ),
-      is_sorted( false )
+      is_sorted( false ),
+      is_sketched( false ),
+      _sketch(),
+      _moments()
   {
   }
 
@@ -347,6 +481,26 @@ public:
     clear();
   }
 
+  /* Switch a !simple container to sketched mode with the given quantile sketch compression.
+   * Compression of 0 disables sketched mode.
+   */
+  void change_sketch( double compression )
+  {
+    if ( simple )
+      return;
+
+    is_sketched = compression > 0;
+    if ( is_sketched )
+      _sketch = quantile_sketch_t( compression );
+
+    clear();
+  }
+
+  bool sketched() const
+  {
+    return is_sketched;
+  }
+
   const std::string& name() const
   {
     return name_str;
@@ -355,7 +509,7 @@ public:
   // Reserve memory
   void reserve( std::size_t capacity )
   {
-    if ( !simple )
+    if ( !simple && !is_sketched )
       _data.reserve( capacity );
   }
 
@@ -366,13 +520,29 @@ public:
     {
       base_t::add( x );
     }
+    else if ( is_sketched )
+    {
+      base_t::add( x );
+      _moments.add( x );
+      _sketch.add( x );
+      is_sorted = false;
+    }
     else
     {
       _data.push_back( x );
+      _moments.add( x );
       is_sorted = false;
     }
   }
 
+  /* Running count, mean and variance of the samples added so far ( !simple only ). Does not
+   * require analysis, so it is cheap to query while samples are still being collected.
+   */
+  const running_moments_t& moments() const
+  {
+    return _moments;
+  }
+
   bool sorted() const
   {
     return is_sorted;
@@ -380,7 +550,7 @@ public:
 
   size_t size() const
   {
-    if ( simple )
+    if ( simple || is_sketched )
       return base_t::count();
 
     return _data.size();
@@ -405,6 +575,13 @@ public:
     if ( simple )
       return;
 
+    if ( is_sketched )
+    {  // Sum and min/max are collected on the fly
+      if ( base_t::count() )
+        _mean = base_t::_sum / base_t::count();
+      return;
+    }
+
     if ( data().empty() )
       return;
 
@@ -415,9 +592,10 @@ public:
     }
     else
     {
-      auto minmax = std::minmax_element( data().begin(), data().end() );
-      base_t::set_min( *minmax.first );
-      base_t::set_max( *minmax.second );
+      value_t min, max;
+      statistics::kernel::minmax( data().data(), data().size(), min, max );
+      base_t::set_min( min );
+      base_t::set_max( max );
     }
 
     base_t::_sum = statistics::calculate_sum( data() );
@@ -434,7 +612,7 @@ public:
   }
   size_t count() const
   {
-    return simple ? base_t::count() : data().size();
+    return simple || is_sketched ? base_t::count() : data().size();
   }
 
   /* Analyze Variance: Variance, Stddev and Stddev of the mean
@@ -445,16 +623,19 @@ public:
     if ( simple )
       return;
 
-    if ( _data.empty() )
+    if ( count() == 0 )
       return;
 
-    variance = statistics::calculate_variance( data(), mean() );
+    if ( is_sketched )
+      variance = _moments.variance();
+    else
+      variance = statistics::calculate_variance( data(), mean() );
     std_dev  = std::sqrt( variance );
 
     // Calculate Standard Deviation of the Mean ( Central Limit Theorem )
-    if ( data().size() > 1 )
+    if ( count() > 1 )
     {
-      mean_variance = variance / data().size();
+      mean_variance = variance / count();
       mean_std_dev  = std::sqrt( mean_variance );
     }
   }
@@ -471,6 +652,12 @@ public:
     {
       return;
     }
+    if ( is_sketched )
+    {
+      _sketch.compress();
+      is_sorted = true;
+      return;
+    }
     _sorted_data = _data;
     range::sort( _sorted_data );
     is_sorted = true;
@@ -485,6 +672,12 @@ public:
     if ( simple )
       return;
 
+    if ( is_sketched )
+    {
+      create_sketch_histogram( num_buckets );
+      return;
+    }
+
     if ( data().empty() )
       return;
 
@@ -498,6 +691,8 @@ public:
     _sorted_data.clear();
     _data.clear();
     distribution.clear();
+    _sketch.clear();
+    _moments.reset();
   }
 
   // Access functions
@@ -510,12 +705,15 @@ public:
     if ( simple )
       return 0;
 
-    if ( data().empty() )
+    if ( count() == 0 )
       return 0;
 
     if ( !is_sorted )
       return base_t::nan();
 
+    if ( is_sketched )
+      return _sketch.quantile( x );
+
     // Should be improved to use linear interpolation
     return ( sorted_data()[ (int)( x * ( sorted_data().size() - 1 ) ) ] );
   }
@@ -532,13 +730,52 @@ public:
   void merge( const extended_sample_data_t& other )
   {
     assert( simple == other.simple );
+    assert( is_sketched == other.is_sketched );
 
     if ( simple )
     {
       base_t::merge( other );
     }
+    else if ( is_sketched )
+    {
+      base_t::merge( other );
+      _moments.merge( other._moments );
+      _sketch.merge( other._sketch );
+      is_sorted = false;
+    }
     else
+    {
       _data.insert( _data.end(), other._data.begin(), other._data.end() );
+      _moments.merge( other._moments );
+    }
+  }
+
+private:
+
+  // Bucket counts from the sketch cdf. Counts are rounded on the cumulative distribution, so the
+  // buckets always add up to the number of samples.
+  void create_sketch_histogram( unsigned int num_buckets )
+  {
+    if ( count() == 0 || base_t::max() <= base_t::min() )
+      return;
+
+    _sketch.compress();
+
+    auto n     = as<double>( count() );
+    auto range = base_t::max() - base_t::min();
+
+    distribution.assign( num_buckets, size_t{} );
+    size_t previous = 0;
+    for ( unsigned int i = 0; i < num_buckets; ++i )
+    {
+      size_t cumulative = i + 1 == num_buckets
+                              ? count()
+                              : static_cast<size_t>( std::round(
+                                    n * _sketch.cdf( base_t::min() + range * ( i + 1 ) / num_buckets ) ) );
+      cumulative        = std::max( cumulative, previous );
+      distribution[ i ] = cumulative - previous;
+      previous          = cumulative;
+    }
   }
 
 };  // sample_data_t
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstring>
 #include <numeric>
 #include <vector>
@@ -94,31 +95,32 @@ public:
   void resize( size_t length )
   { _data.resize( length ); }
 
+  // Preallocate storage for 'length' bins, so adding to them never reallocates
+  void reserve( size_t length )
+  { _data.reserve( length ); }
+
   // Add 'value' at the specific index
   void add( size_t index, double value )
   {
-    if ( index >= _data.capacity() ) // we need to reallocate
-    {
-      // Reserve data less aggressively than doubling the size every time
-      _data.reserve( std::max( size_t( 10 ), static_cast<size_t>( index * 1.25 ) ) );
-      _data.resize( index + 1 );
-    }
-    else if ( index >= _data.size() ) // we still have enough capacity left, but need to resize up to index
+    if ( index >= _data.size() )
     {
-      _data.resize( index + 1 );
+      grow( index );
     }
     _data[ index ] += value;
   }
 
   // Adjust timeline by dividing through divisor timeline
-  template <class A>
-  void adjust( const std::vector<A>& divisor_timeline )
+  void adjust( const std::vector<double>& divisor_timeline )
   {
+    statistics::kernel::divide( _data.data(), divisor_timeline.data(),
+                                std::min( _data.size(), divisor_timeline.size() ) );
+  }
 
-    for ( size_t j = 0, size = std::min( data().size(), divisor_timeline.size() ); j < size; j++ )
-    {
-      _data[ j ] /= divisor_timeline[ j ];
-    }
+  // Multiply every bin by 'factor'
+  void scale( double factor )
+  {
+    for ( auto& v : _data )
+      v *= factor;
   }
 
   double mean() const
@@ -141,8 +143,7 @@ public:
   void merge( const timeline_t& other )
   {
     // merge shared range
-    for ( size_t j = 0, num_buckets = std::min( _data.size(), other.data().size() ); j < num_buckets; ++j )
-      _data[ j ] += other.data()[ j ];
+    statistics::kernel::add( _data.data(), other.data().data(), std::min( _data.size(), other.data().size() ) );
 
     // if other is larger, insert tail
     if ( _data.size() < other.data().size() )
@@ -166,6 +167,19 @@ public:
   void clear()
   { _data.clear(); }
 
+private:
+  // Extend the timeline up to index. Preallocated timelines only resize within their capacity.
+  void grow( size_t index )
+  {
+    if ( index >= _data.capacity() )
+    {
+      // Reserve data less aggressively than doubling the size every time
+      _data.reserve( std::max( size_t( 10 ), static_cast<size_t>( index * 1.25 ) ) );
+    }
+    _data.resize( index + 1 );
+  }
+
+public:
   /*
     // Functions which could be implemented:
     data_type variance() const;
@@ -367,6 +381,11 @@ struct sc_timeline_t : public timeline_t
   }
 
   using timeline_t::add;
+  using timeline_t::reserve;
+
+  // Preallocate bins up to max_time
+  void reserve( timespan_t max_time )
+  { timeline_t::reserve( bin_index( max_time ) + 1 ); }
 
   // Add 'value' at the corresponding time
   void add( timespan_t current_time, double value )
@@ -387,8 +406,17 @@ struct sc_timeline_t : public timeline_t
   void adjust( sim_t& sim );
   void adjust( const extended_sample_data_t& adjustor );
 
+  // Per-second rate, averaged over a 20 second window
   void build_derivative_timeline( sc_timeline_t& out ) const
-  { timeline_t::build_sliding_average_timeline( out, 20 ); }
+  {
+    out.set_bin_size( bin_size_ );
+    timeline_t::build_sliding_average_timeline(
+        out, std::max( 1U, static_cast<unsigned>( std::lround( 20 / bin_size_ ) ) ) );
+    if ( bin_size_ != 1 )
+    {
+      out.scale( 1 / bin_size_ );
+    }
+  }
 
 private:
   size_t bin_index( timespan_t time ) const
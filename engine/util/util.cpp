@@ -1354,6 +1354,22 @@ const char* util::movement_direction_string( movement_direction_type m )
   }
 }
 
+// ready_failure_string =====================================================
+
+const char* util::ready_failure_string( ready_failure f )
+{
+  switch ( f )
+  {
+    case ready_failure::COOLDOWN: return "cooldown";
+    case ready_failure::RESOURCE: return "resource";
+    case ready_failure::TARGET: return "target";
+    case ready_failure::EXPRESSION: return "expression";
+    case ready_failure::OTHER: return "other";
+    case ready_failure::NONE: return "none";
+    default: return "";
+  }
+}
+
 // parse_movement_type ======================================================
 
 movement_direction_type util::parse_movement_direction( util::string_view name )
@@ -1856,6 +1872,20 @@ bool util::scale_metric_is_raid( scale_metric_e sm )
   }
 }
 
+// scale_metric_is_lower_better ===============================================
+bool util::scale_metric_is_lower_better( scale_metric_e sm )
+{
+  switch ( sm )
+  {
+    case SCALE_METRIC_DTPS:
+    case SCALE_METRIC_DMG_TAKEN:
+    case SCALE_METRIC_DEATHS:
+      return true;
+    default:
+      return false;
+  }
+}
+
 // scale_metric_type_string ===================================================
 
 const char* util::scale_metric_type_string( scale_metric_e sm )
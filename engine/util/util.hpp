@@ -82,6 +82,7 @@ const char* weapon_subclass_string    ( int subclass );
 const char* item_quality_string       ( int quality );
 const char* specialization_string     ( specialization_e spec );
 const char* movement_direction_string( movement_direction_type );
+const char* ready_failure_string( ready_failure );
 const char* spec_string_no_class( const player_t&p );
 const char* retarget_event_string     ( retarget_source );
 const char* buff_refresh_behavior_string   ( buff_refresh_behavior );
@@ -155,6 +156,7 @@ profession_e translate_profession_id( int skill_id );
 bool socket_gem_match( item_socket_color socket, item_socket_color gem );
 double crit_multiplier( meta_gem_e gem );
 bool scale_metric_is_raid( scale_metric_e );
+bool scale_metric_is_lower_better( scale_metric_e );
 
 
 template<typename StringType = std::string>
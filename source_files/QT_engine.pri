@@ -183,6 +183,7 @@ HEADERS += engine/util/generic.hpp
 HEADERS += engine/util/git_info.hpp
 HEADERS += engine/util/io.hpp
 HEADERS += engine/util/plot_data.hpp
+HEADERS += engine/util/quantile_sketch.hpp
 HEADERS += engine/util/resourcepaths.hpp
 HEADERS += engine/util/rng.hpp
 HEADERS += engine/util/sample_data.hpp
@@ -369,6 +370,7 @@ SOURCES += engine/util/concurrency.cpp
 SOURCES += engine/util/git_info.cpp
 SOURCES += engine/util/io.cpp
 SOURCES += engine/util/rng.cpp
+SOURCES += engine/util/sample_data.cpp
 SOURCES += engine/util/timespan.cpp
 SOURCES += engine/util/util.cpp
 SOURCES += engine/util/xml.cpp
@@ -1,4 +1,4 @@
-import sys, os, shutil, subprocess, re, signal
+import sys, os, shutil, subprocess, re, signal, json
 from pathlib import Path
 
 def __error_status(code):
@@ -57,6 +57,10 @@ class Test(object):
         self._all_talents = kwargs.get('all_talents', False)
         self._all_sets = kwargs.get('all_sets', False)
         self._args = kwargs.get('args', [])
+        # Optional callable checking the json2 report of a successful run, returns an error
+        # message or None
+        self._check = kwargs.get('check')
+        self._json = kwargs.get('json')
 
     def args(self):
         args = [
@@ -79,8 +83,16 @@ class Test(object):
                 args.append('{}={}'.format(*arg))
             else:
                 args.append(str(arg))
+        if self._check:
+            args.append('json2={}'.format(self._json))
         return args
 
+    def check(self):
+        if not self._check:
+            return None
+        with open(self._json, encoding='UTF-8') as f:
+            return self._check(json.load(f))
+
 SIMC_WALL_SECONDS_RE = re.compile('WallSeconds\\s*=\\s*([0-9\\.]+)')
 def run_test(test):
     args = [ SIMC_CLI_PATH ]
@@ -89,6 +101,9 @@ def run_test(test):
     try:
         res = subprocess.run(args, check=True, stdout=subprocess.PIPE, stderr=subprocess.PIPE, encoding='UTF-8', timeout=30)
         wall_time = SIMC_WALL_SECONDS_RE.search(res.stdout)
+        error = test.check()
+        if error:
+            return ( False, 0, None, error )
         return ( True, float(wall_time.group(1)), None, res.stderr )
     except subprocess.CalledProcessError as err:
         return ( False, 0, err, err.stderr)
@@ -110,8 +125,11 @@ def run(tests):
             success += 1
         else:
             print('[FAIL]')
-            print('-- {:<62} --------------'.format(__error_status(err.returncode)))
-            print(err.cmd)
+            if err:
+                print('-- {:<62} --------------'.format(__error_status(err.returncode)))
+                print(err.cmd)
+            else:
+                print('-- {:<62} --------------'.format('Report check failed'))
             if stderr:
                 print(stderr.rstrip('\r\n'))
             print('-' * 80)
@@ -72,9 +72,81 @@ def test_baseline(klass: str, path: str, enable: dict):
         ],
     )
 
+# Test iteration pairing: a profileset identical to the baseline replays every baseline iteration,
+# so all paired differences are zero. The first iteration of each thread is not collected.
+def check_paired(threads: int):
+    def check(report):
+        results = report["sim"]["profilesets"]["results"]
+        for result in results:
+            collected = result["iterations"] - threads
+            if result.get("paired_iterations") != collected:
+                return "{}: {} of {} iterations paired".format(
+                    result["name"], result.get("paired_iterations", 0), collected)
+            if result["paired_delta"] != 0:
+                return "{}: paired_delta = {}".format(result["name"], result["paired_delta"])
+        return None if results else "No profileset results"
+    return check
+
+def test_paired(klass: str, path: str, enable: dict):
+    fight_style = "Patchwerk"
+    grp = TestGroup(
+        "{}/{}/paired".format(profile, fight_style),
+        fight_style=fight_style,
+        profile=path,
+    )
+    tests.append(grp)
+    for threads in (1, 2, 4):
+        Test(
+            "identical profileset, {} threads".format(threads),
+            group=grp,
+            threads=threads,
+            check=check_paired(threads),
+            json="paired_{}.json".format(threads),
+            args=[
+                # Target health estimation carries over between iterations
+                ( "override.target_health", "100000000" ),
+                ( "profileset_paired", "1" ),
+                ( "profileset.identical+", "report_details=0" ),
+            ],
+        )
+
+# Test that player timelines, including resource timelines, use the requested bin size.
+def check_timeline_bin_size(bin_size: float):
+    def check(report):
+        for player in report["sim"]["players"]:
+            timelines = player["collected_data"].get("resource_timelines", {})
+            if not timelines:
+                return "{}: no resource timelines".format(player["name"])
+            for name, timeline in timelines.items():
+                if timeline.get("bin_size") != bin_size:
+                    return "{}: {} timeline bin_size = {}".format(
+                        player["name"], name, timeline.get("bin_size"))
+        return None
+    return check
+
+def test_timeline(klass: str, path: str, enable: dict):
+    fight_style = "Patchwerk"
+    grp = TestGroup(
+        "{}/{}/timeline".format(profile, fight_style),
+        fight_style=fight_style,
+        profile=path,
+    )
+    tests.append(grp)
+    Test(
+        "timeline bin size",
+        group=grp,
+        check=check_timeline_bin_size(2.0),
+        json="timeline.json",
+        args=[
+            ( "timeline_bin_size", "2" ),
+        ],
+    )
+
 available_tests = {
     "trinket": test_trinkets,
     "baseline": test_baseline,
+    "paired": test_paired,
+    "timeline": test_timeline,
 }
 
 parser = argparse.ArgumentParser(description="Run simc tests.")